@@ -31,6 +31,9 @@ public:
 
   std::unique_ptr<std::istream> read(const Path &) const final;
 
+  // 128 bit hex identity derived from the content of the whole file
+  std::string fingerprint() const;
+
 private:
   class Impl;
   const std::unique_ptr<Impl> impl;
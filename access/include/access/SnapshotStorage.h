@@ -0,0 +1,60 @@
+#ifndef ODR_ACCESS_SNAPSHOT_STORAGE_H
+#define ODR_ACCESS_SNAPSHOT_STORAGE_H
+
+#include <access/Storage.h>
+#include <stdexcept>
+#include <string>
+
+namespace odr::access {
+
+struct SnapshotException : public std::runtime_error {
+  explicit SnapshotException(const char *desc) : std::runtime_error(desc) {}
+};
+struct NoSnapshotFileException : public SnapshotException {
+  NoSnapshotFileException() : SnapshotException("no snapshot file") {}
+};
+struct SnapshotVersionException : public SnapshotException {
+  SnapshotVersionException()
+      : SnapshotException("unsupported snapshot version") {}
+};
+struct SnapshotCorruptedException : public SnapshotException {
+  SnapshotCorruptedException() : SnapshotException("snapshot corrupted") {}
+};
+
+// uncompressed copy of a storage in one file which is mapped into memory on
+// open. carries an opaque header for the owner and CRC-32 checksums for the
+// entry table and every entry.
+class SnapshotReader final : public ReadStorage {
+public:
+  static constexpr std::uint32_t version = 1;
+
+  // writes all files and directories of `storage` to a temporary file which
+  // is moved to `path` once complete
+  static void write(const Path &path, const ReadStorage &storage,
+                    const std::string &header);
+
+  explicit SnapshotReader(const Path &);
+  ~SnapshotReader() final;
+
+  const std::string &header() const noexcept;
+
+  bool isSomething(const Path &) const final;
+  bool isFile(const Path &) const final;
+  bool isDirectory(const Path &) const final;
+  bool isReadable(const Path &) const final;
+
+  std::uint64_t size(const Path &) const final;
+
+  void visit(Visitor) const final;
+
+  // throws `SnapshotCorruptedException` if the checksum does not match
+  std::unique_ptr<std::istream> read(const Path &) const final;
+
+private:
+  class Impl;
+  const std::unique_ptr<Impl> impl;
+};
+
+} // namespace odr::access
+
+#endif // ODR_ACCESS_SNAPSHOT_STORAGE_H
@@ -2,6 +2,7 @@
 #define ODR_ACCESS_STORAGE_UTIL_H
 
 #include <access/Storage.h>
+#include <cstdint>
 #include <string>
 
 namespace odr::access {
@@ -11,7 +12,10 @@ class ReadStorage;
 
 namespace StorageUtil {
 extern std::string read(const ReadStorage &, const Path &);
-}
+// reads at most `size` bytes from the start of a file; compressed files are
+// only inflated that far
+extern std::string peek(const ReadStorage &, const Path &, std::uint64_t size);
+} // namespace StorageUtil
 
 } // namespace odr::access
 
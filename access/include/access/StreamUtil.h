@@ -2,6 +2,7 @@
 #define ODR_ACCESS_STREAMUTIL_H
 
 #include <iostream>
+#include <memory>
 #include <string>
 
 namespace odr::access::StreamUtil {
@@ -10,6 +11,10 @@ extern std::string read(std::istream &);
 
 extern void pipe(std::istream &, std::ostream &);
 
+// reads `prefix` first and continues with `rest`
+extern std::unique_ptr<std::istream> prepend(std::string prefix,
+                                             std::unique_ptr<std::istream> rest);
+
 } // namespace odr::access::StreamUtil
 
 #endif // ODR_ACCESS_STREAMUTIL_H
@@ -3,6 +3,8 @@
 
 #include <access/Storage.h>
 #include <exception>
+#include <memory>
+#include <vector>
 
 namespace odr::access {
 
@@ -20,6 +22,35 @@ private:
 
 class ZipReader final : public ReadStorage {
 public:
+  // inflate states of one entry recorded while reading it. reading can later
+  // continue from the closest state before an offset instead of inflating
+  // everything from the start.
+  class Checkpoints final {
+  public:
+    // defined in the translation unit; holds the inflate state and window
+    struct Checkpoint;
+
+    // one checkpoint costs about 45 KB
+    explicit Checkpoints(std::uint64_t interval = 1024 * 1024);
+    Checkpoints(const Checkpoints &) = delete;
+    ~Checkpoints();
+    Checkpoints &operator=(const Checkpoints &) = delete;
+
+    std::uint64_t interval() const noexcept { return interval_; }
+    std::size_t size() const noexcept { return checkpoints_.size(); }
+
+    void add(std::unique_ptr<Checkpoint>);
+    // closest checkpoint at or before `offset`; null if there is none
+    const Checkpoint *find(std::uint64_t offset) const noexcept;
+    // keeps only the closest checkpoints before each of `offsets`
+    void retain(const std::vector<std::uint64_t> &offsets);
+
+  private:
+    std::uint64_t interval_;
+    // ordered by offset
+    std::vector<std::unique_ptr<Checkpoint>> checkpoints_;
+  };
+
   ZipReader(const void *, std::uint64_t size);
   ZipReader(const std::string &zip, bool dummy);
   explicit ZipReader(const Path &);
@@ -35,6 +66,19 @@ public:
   void visit(Visitor) const final;
 
   std::unique_ptr<std::istream> read(const Path &) const final;
+  // records a checkpoint into `checkpoints` every `interval` uncompressed
+  // bytes while reading; `checkpoints` has to outlive the stream
+  std::unique_ptr<std::istream> read(const Path &,
+                                     Checkpoints &checkpoints) const;
+  // starts reading at the uncompressed `offset` using the checkpoints
+  // recorded by a previous read of the same entry
+  std::unique_ptr<std::istream> read(const Path &,
+                                     const Checkpoints &checkpoints,
+                                     std::uint64_t offset) const;
+
+  // 128 bit hex identity derived from the central directory (names, CRC-32s,
+  // sizes) and small stored entries; nothing gets inflated
+  std::string fingerprint() const;
 
 private:
   class Impl;
@@ -2,6 +2,7 @@
 #include <access/FileUtil.h>
 #include <access/Path.h>
 #include <codecvt>
+#include <crypto/CryptoUtil.h>
 #include <cstdint>
 #include <cstring>
 #include <functional>
@@ -523,6 +524,12 @@ public:
     return std::make_unique<CfbReaderIstream>(reader, *entry);
   }
 
+  std::string fingerprint() const {
+    // the whole file is in memory already; editors may rewrite big streams
+    // without touching sizes or timestamps
+    return crypto::Util::hexEncode(crypto::Util::sha256(buffer).substr(0, 16));
+  }
+
 private:
   std::string buffer;
   CFB::CompoundFileReader reader;
@@ -556,4 +563,6 @@ std::unique_ptr<std::istream> CfbReader::read(const Path &path) const {
   return impl->read(path);
 }
 
+std::string CfbReader::fingerprint() const { return impl->fingerprint(); }
+
 } // namespace odr::access
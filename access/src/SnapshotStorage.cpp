@@ -0,0 +1,366 @@
+#include <access/FileUtil.h>
+#include <access/Path.h>
+#include <access/SnapshotStorage.h>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <miniz.h>
+#include <streambuf>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ODR_SNAPSHOT_MMAP
+#endif
+
+namespace odr::access {
+
+namespace {
+// magic, version, table checksum, table offset, table size
+constexpr char magic_[8] = {'O', 'D', 'R', 'S', 'N', 'A', 'P', '\x1a'};
+constexpr std::uint64_t prefixSize_ = 8 + 4 + 4 + 8 + 8;
+constexpr std::uint32_t bufferSize_ = 4096;
+
+void appendInt(std::string &out, std::uint64_t value, const int bytes) {
+  for (int i = 0; i < bytes; ++i, value >>= 8) {
+    out += static_cast<char>(value & 0xff);
+  }
+}
+
+void appendString(std::string &out, const std::string &value) {
+  appendInt(out, value.size(), 4);
+  out += value;
+}
+
+std::uint64_t readInt(const char *&it, const char *end, const int bytes) {
+  if (end - it < bytes)
+    throw SnapshotCorruptedException();
+  std::uint64_t result = 0;
+  for (int i = 0; i < bytes; ++i) {
+    result |= std::uint64_t(static_cast<unsigned char>(*it++)) << (8 * i);
+  }
+  return result;
+}
+
+std::string readString(const char *&it, const char *end) {
+  const std::uint64_t size = readInt(it, end, 4);
+  if (static_cast<std::uint64_t>(end - it) < size)
+    throw SnapshotCorruptedException();
+  std::string result(it, size);
+  it += size;
+  return result;
+}
+
+std::uint32_t crc32(const char *data, const std::uint64_t size) {
+  return static_cast<std::uint32_t>(mz_crc32(
+      MZ_CRC32_INIT, reinterpret_cast<const unsigned char *>(data), size));
+}
+
+class MemoryBuf final : public std::streambuf {
+public:
+  MemoryBuf(const char *data, const std::uint64_t size) {
+    char *begin = const_cast<char *>(data);
+    setg(begin, begin, begin + size);
+  }
+
+protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode) final {
+    char *target = gptr();
+    if (dir == std::ios_base::beg)
+      target = eback() + off;
+    else if (dir == std::ios_base::cur)
+      target = gptr() + off;
+    else if (dir == std::ios_base::end)
+      target = egptr() + off;
+    if ((target < eback()) || (target > egptr()))
+      return pos_type(off_type(-1));
+    setg(eback(), target, egptr());
+    return pos_type(target - eback());
+  }
+
+  pos_type seekpos(pos_type pos, std::ios_base::openmode mode) final {
+    return seekoff(off_type(pos), std::ios_base::beg, mode);
+  }
+};
+
+class MemoryIstream final : public std::istream {
+public:
+  MemoryIstream(const char *data, const std::uint64_t size)
+      : std::istream(nullptr), sbuf_(data, size) {
+    rdbuf(&sbuf_);
+  }
+
+private:
+  MemoryBuf sbuf_;
+};
+
+// the mapped or read file, released even if parsing the snapshot throws
+class Mapping final {
+public:
+  explicit Mapping(const Path &path) {
+#ifdef ODR_SNAPSHOT_MMAP
+    const int fd = open(path.string().c_str(), O_RDONLY);
+    if (fd < 0)
+      throw FileNotFoundException(path.string());
+    struct stat status {};
+    if (fstat(fd, &status) != 0) {
+      close(fd);
+      throw FileNotFoundException(path.string());
+    }
+    size_ = status.st_size;
+    // other documents are rejected without mapping them
+    char prefix[sizeof(magic_)];
+    if (!S_ISREG(status.st_mode) || (size_ < prefixSize_) ||
+        (::read(fd, prefix, sizeof(prefix)) != sizeof(prefix)) ||
+        (std::memcmp(prefix, magic_, sizeof(magic_)) != 0)) {
+      close(fd);
+      throw NoSnapshotFileException();
+    }
+    void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+      throw NoSnapshotFileException();
+    data_ = static_cast<const char *>(data);
+#else
+    std::error_code ec;
+    if (!std::filesystem::exists(path.string(), ec))
+      throw FileNotFoundException(path.string());
+    if (!std::filesystem::is_regular_file(path.string(), ec))
+      throw NoSnapshotFileException();
+    // other documents are rejected without reading them
+    {
+      std::ifstream in(path.string(), std::ios::binary);
+      char prefix[sizeof(magic_)];
+      if (!in.read(prefix, sizeof(prefix)) ||
+          (std::memcmp(prefix, magic_, sizeof(magic_)) != 0))
+        throw NoSnapshotFileException();
+    }
+    buffer_ = FileUtil::read(path);
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+  }
+
+  Mapping(const Mapping &) = delete;
+  Mapping &operator=(const Mapping &) = delete;
+
+  ~Mapping() {
+#ifdef ODR_SNAPSHOT_MMAP
+    munmap(const_cast<char *>(data_), size_);
+#endif
+  }
+
+  const char *data() const noexcept { return data_; }
+  std::uint64_t size() const noexcept { return size_; }
+
+private:
+  const char *data_{nullptr};
+  std::uint64_t size_{0};
+  std::string buffer_;
+};
+} // namespace
+
+class SnapshotReader::Impl final {
+public:
+  struct Entry {
+    bool directory;
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::uint32_t crc;
+    bool verified{false};
+  };
+
+  explicit Impl(const Path &path) : mapping_{path} {
+    const char *data = mapping_.data();
+    const std::uint64_t size = mapping_.size();
+
+    const char *it = data;
+    const char *end = data + size;
+    if ((size < prefixSize_) || (std::memcmp(it, magic_, sizeof(magic_)) != 0))
+      throw NoSnapshotFileException();
+    it += sizeof(magic_);
+    if (readInt(it, end, 4) != version)
+      throw SnapshotVersionException();
+    const std::uint64_t tableCrc = readInt(it, end, 4);
+    const std::uint64_t tableOffset = readInt(it, end, 8);
+    const std::uint64_t tableSize = readInt(it, end, 8);
+    if ((tableOffset > size) || (tableSize > size - tableOffset) ||
+        (crc32(data + tableOffset, tableSize) != tableCrc))
+      throw SnapshotCorruptedException();
+
+    it = data + tableOffset;
+    end = it + tableSize;
+    header = readString(it, end);
+    const std::uint64_t count = readInt(it, end, 4);
+    for (std::uint64_t i = 0; i < count; ++i) {
+      const Path entryPath = readString(it, end);
+      Entry entry;
+      entry.directory = readInt(it, end, 1) != 0;
+      entry.offset = readInt(it, end, 8);
+      entry.size = readInt(it, end, 8);
+      entry.crc = readInt(it, end, 4);
+      if ((entry.offset > tableOffset) ||
+          (entry.size > tableOffset - entry.offset))
+        throw SnapshotCorruptedException();
+      order.push_back(entryPath);
+      entries.insert({entryPath, entry});
+    }
+  }
+
+  const Entry *find(const Path &path) const {
+    const auto it = entries.find(path);
+    if (it == entries.end())
+      return nullptr;
+    return &it->second;
+  }
+
+  std::unique_ptr<std::istream> read(const Path &path) {
+    const auto it = entries.find(path);
+    if ((it == entries.end()) || it->second.directory)
+      return nullptr;
+    Entry &entry = it->second;
+    if (!entry.verified) {
+      if (crc32(mapping_.data() + entry.offset, entry.size) != entry.crc)
+        throw SnapshotCorruptedException();
+      entry.verified = true;
+    }
+    return std::make_unique<MemoryIstream>(mapping_.data() + entry.offset,
+                                           entry.size);
+  }
+
+  std::string header;
+  std::unordered_map<Path, Entry> entries;
+  std::vector<Path> order;
+
+private:
+  Mapping mapping_;
+};
+
+void SnapshotReader::write(const Path &path, const ReadStorage &storage,
+                           const std::string &header) {
+  struct Entry {
+    std::string path;
+    bool directory;
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::uint32_t crc;
+  };
+
+  const std::string tempPath = path.string() + ".tmp";
+
+  {
+    std::ofstream out(tempPath, std::ios::binary);
+    if (!out.is_open())
+      throw FileNotCreatedException(path.string());
+    out.write(std::string(prefixSize_, '\0').data(), prefixSize_);
+
+    std::vector<Entry> entries;
+    std::uint64_t offset = prefixSize_;
+    char buffer[bufferSize_];
+    storage.visit([&](const Path &p) {
+      Entry entry{p.string(), storage.isDirectory(p), offset, 0, MZ_CRC32_INIT};
+      if (!entry.directory) {
+        const auto in = storage.read(p);
+        if (!in)
+          throw FileNotFoundException(p.string());
+        while (true) {
+          in->read(buffer, bufferSize_);
+          const auto read = in->gcount();
+          if (read == 0)
+            break;
+          out.write(buffer, read);
+          entry.crc = static_cast<std::uint32_t>(
+              mz_crc32(entry.crc, reinterpret_cast<unsigned char *>(buffer),
+                       read));
+          entry.size += read;
+        }
+        offset += entry.size;
+      }
+      entries.push_back(std::move(entry));
+    });
+
+    std::string table;
+    appendString(table, header);
+    appendInt(table, entries.size(), 4);
+    for (auto &&e : entries) {
+      appendString(table, e.path);
+      appendInt(table, e.directory ? 1 : 0, 1);
+      appendInt(table, e.offset, 8);
+      appendInt(table, e.size, 8);
+      appendInt(table, e.crc, 4);
+    }
+    out.write(table.data(), table.size());
+
+    std::string prefix(magic_, sizeof(magic_));
+    appendInt(prefix, version, 4);
+    appendInt(prefix, crc32(table.data(), table.size()), 4);
+    appendInt(prefix, offset, 8);
+    appendInt(prefix, table.size(), 8);
+    out.seekp(0);
+    out.write(prefix.data(), prefix.size());
+
+    out.close();
+    if (out.fail()) {
+      std::remove(tempPath.c_str());
+      throw FileNotCreatedException(path.string());
+    }
+  }
+
+  // readers never see partial snapshots
+  if (std::rename(tempPath.c_str(), path.string().c_str()) != 0) {
+    std::remove(tempPath.c_str());
+    throw FileNotCreatedException(path.string());
+  }
+}
+
+SnapshotReader::SnapshotReader(const Path &path)
+    : impl(std::make_unique<Impl>(path)) {}
+
+SnapshotReader::~SnapshotReader() = default;
+
+const std::string &SnapshotReader::header() const noexcept {
+  return impl->header;
+}
+
+bool SnapshotReader::isSomething(const Path &path) const {
+  return impl->find(path) != nullptr;
+}
+
+bool SnapshotReader::isFile(const Path &path) const {
+  const auto entry = impl->find(path);
+  return (entry != nullptr) && !entry->directory;
+}
+
+bool SnapshotReader::isDirectory(const Path &path) const {
+  const auto entry = impl->find(path);
+  return (entry != nullptr) && entry->directory;
+}
+
+bool SnapshotReader::isReadable(const Path &path) const {
+  return isFile(path);
+}
+
+std::uint64_t SnapshotReader::size(const Path &path) const {
+  const auto entry = impl->find(path);
+  if (entry == nullptr)
+    return 0;
+  return entry->size;
+}
+
+void SnapshotReader::visit(Visitor visitor) const {
+  for (auto &&p : impl->order) {
+    visitor(p);
+  }
+}
+
+std::unique_ptr<std::istream> SnapshotReader::read(const Path &path) const {
+  return impl->read(path);
+}
+
+} // namespace odr::access
@@ -1,3 +1,4 @@
+#include <access/Path.h>
 #include <access/Storage.h>
 #include <access/StorageUtil.h>
 #include <access/StreamUtil.h>
@@ -10,4 +11,15 @@ std::string StorageUtil::read(const ReadStorage &storage, const Path &path) {
   return StreamUtil::read(*in);
 }
 
+std::string StorageUtil::peek(const ReadStorage &storage, const Path &path,
+                              const std::uint64_t size) {
+  const auto in = storage.read(path);
+  if (!in)
+    throw FileNotFoundException(path.string());
+  std::string result(size, '\0');
+  in->read(result.data(), size);
+  result.resize(in->gcount());
+  return result;
+}
+
 } // namespace odr::access
@@ -1,10 +1,49 @@
 #include <access/StreamUtil.h>
+#include <streambuf>
 
 namespace odr::access {
 
 namespace {
 constexpr std::uint32_t bufferSize_ = 4096;
-}
+
+class PrependBuf final : public std::streambuf {
+public:
+  PrependBuf(std::string prefix, std::unique_ptr<std::istream> rest)
+      : prefix_{std::move(prefix)}, rest_{std::move(rest)} {
+    setg(prefix_.data(), prefix_.data(), prefix_.data() + prefix_.size());
+  }
+
+protected:
+  int_type underflow() final {
+    if (gptr() < egptr())
+      return traits_type::to_int_type(*gptr());
+    if (!rest_)
+      return traits_type::eof();
+    rest_->read(buffer_, bufferSize_);
+    const auto read = rest_->gcount();
+    if (read <= 0)
+      return traits_type::eof();
+    setg(buffer_, buffer_, buffer_ + read);
+    return traits_type::to_int_type(*gptr());
+  }
+
+private:
+  std::string prefix_;
+  std::unique_ptr<std::istream> rest_;
+  char buffer_[bufferSize_];
+};
+
+class PrependIstream final : public std::istream {
+public:
+  PrependIstream(std::string prefix, std::unique_ptr<std::istream> rest)
+      : std::istream(nullptr), sbuf_(std::move(prefix), std::move(rest)) {
+    rdbuf(&sbuf_);
+  }
+
+private:
+  PrependBuf sbuf_;
+};
+} // namespace
 
 std::string StreamUtil::read(std::istream &in) {
   return std::string{std::istreambuf_iterator<char>(in), {}};
@@ -22,4 +61,9 @@ void StreamUtil::pipe(std::istream &in, std::ostream &out) {
   }
 }
 
+std::unique_ptr<std::istream>
+StreamUtil::prepend(std::string prefix, std::unique_ptr<std::istream> rest) {
+  return std::make_unique<PrependIstream>(std::move(prefix), std::move(rest));
+}
+
 } // namespace odr::access
@@ -1,20 +1,103 @@
 #include <access/Path.h>
 #include <access/ZipStorage.h>
+#include <algorithm>
+#include <crypto/CryptoUtil.h>
+#include <cstring>
 #include <miniz.h>
 #include <sstream>
 #include <streambuf>
+#include <type_traits>
 #include <utility>
 
 namespace odr::access {
 
 namespace {
 constexpr std::uint64_t buffer_size_ = 4098;
+// stored entries up to this size are hashed by content
+constexpr std::uint64_t fingerprint_content_size_ = 1024;
+
+void appendInt(std::string &out, std::uint64_t value) {
+  for (int i = 0; i < 8; ++i, value >>= 8) {
+    out += static_cast<char>(value & 0xff);
+  }
+}
+
+// `tinfl_decompressor` of the pinned miniz
+struct InflatorLayout {
+  mz_uint32 header[11 + TINFL_MAX_HUFF_TABLES];
+  tinfl_bit_buf_t bitBuffer;
+  std::size_t distanceFromOutput;
+  tinfl_huff_table tables[TINFL_MAX_HUFF_TABLES];
+  mz_uint8 rawHeader[4];
+  mz_uint8 lengthCodes[TINFL_MAX_HUFF_SYMBOLS_0 + TINFL_MAX_HUFF_SYMBOLS_1 +
+                       137];
+};
+} // namespace
+
+// checkpoints copy the extraction state of miniz by value and only rebase the
+// two buffers it points to. this relies on internals of the version pinned in
+// 3rdparty/CMakeLists.txt; recheck `capture` and `restore` when these fail
+static_assert(std::is_trivially_copyable_v<mz_zip_reader_extract_iter_state>);
+static_assert(sizeof(tinfl_decompressor) == sizeof(InflatorLayout),
+              "unexpected miniz inflator layout");
+
+struct ZipReader::Checkpoints::Checkpoint {
+  mz_zip_reader_extract_iter_state state;
+  // unconsumed input of file backed archives
+  std::string input;
+  // inflate window
+  std::string dictionary;
+};
+
+namespace {
+std::unique_ptr<ZipReader::Checkpoints::Checkpoint>
+capture(const mz_zip_reader_extract_iter_state &iter, const bool inMemory) {
+  auto result = std::make_unique<ZipReader::Checkpoints::Checkpoint>();
+  result->state = iter;
+  if (iter.file_stat.m_method != 0) {
+    result->dictionary.assign(static_cast<const char *>(iter.pWrite_buf),
+                              TINFL_LZ_DICT_SIZE);
+    if (!inMemory)
+      result->input.assign(static_cast<const char *>(iter.pRead_buf) +
+                               iter.read_buf_ofs,
+                           iter.read_buf_avail);
+  }
+  return result;
+}
+
+// `iter` is freshly created for the same entry and owns its buffers
+void restore(mz_zip_reader_extract_iter_state &iter,
+             const ZipReader::Checkpoints::Checkpoint &checkpoint,
+             const bool inMemory) {
+  void *readBuffer = iter.pRead_buf;
+  void *writeBuffer = iter.pWrite_buf;
+  iter = checkpoint.state;
+  iter.pRead_buf = readBuffer;
+  iter.pWrite_buf = writeBuffer;
+  if (iter.file_stat.m_method == 0) {
+    // stored entries of mem archives advance the read pointer
+    if (inMemory)
+      iter.pRead_buf = static_cast<char *>(readBuffer) + iter.out_buf_ofs;
+    return;
+  }
+  std::memcpy(writeBuffer, checkpoint.dictionary.data(),
+              checkpoint.dictionary.size());
+  if (!inMemory)
+    std::memcpy(static_cast<char *>(readBuffer) + iter.read_buf_ofs,
+                checkpoint.input.data(), checkpoint.input.size());
+}
 
 class ZipReaderBuf final : public std::streambuf {
 public:
-  explicit ZipReaderBuf(mz_zip_reader_extract_iter_state *iter)
-      : iter_(iter), remaining_(iter->file_stat.m_uncomp_size),
-        buffer_(new char[buffer_size_]) {}
+  ZipReaderBuf(mz_zip_reader_extract_iter_state *iter,
+               ZipReader::Checkpoints *checkpoints, const bool inMemory)
+      : iter_(iter), remaining_(iter->file_stat.m_uncomp_size -
+                                iter->out_buf_ofs),
+        buffer_(new char[buffer_size_]), checkpoints_{checkpoints},
+        inMemory_{inMemory} {
+    if (checkpoints_ != nullptr)
+      nextCheckpoint_ = checkpoints_->interval();
+  }
 
   ~ZipReaderBuf() final {
     mz_zip_reader_extract_iter_free(iter_);
@@ -26,18 +109,48 @@ public:
       return std::char_traits<char>::eof();
 
     const std::uint64_t amount = std::min(remaining_, buffer_size_);
-    const std::uint32_t result =
-        mz_zip_reader_extract_iter_read(iter_, buffer_, amount);
-    remaining_ -= result;
+    const std::uint32_t result = inflate_(buffer_, amount);
     this->setg(this->buffer_, this->buffer_, this->buffer_ + result);
+    if (result == 0)
+      return std::char_traits<char>::eof();
 
     return std::char_traits<char>::to_int_type(*gptr());
   }
 
+  std::streamsize xsgetn(char *s, std::streamsize count) final {
+    // drain the buffer first, then inflate large reads straight into `s`
+    std::streamsize result = std::min<std::streamsize>(count, egptr() - gptr());
+    std::memcpy(s, gptr(), result);
+    gbump(static_cast<int>(result));
+    while ((result < count) && (remaining_ > 0)) {
+      const std::uint64_t amount = std::min<std::uint64_t>(
+          remaining_, static_cast<std::uint64_t>(count - result));
+      const std::uint32_t read = inflate_(s + result, amount);
+      if (read == 0)
+        break;
+      result += read;
+    }
+    return result;
+  }
+
 private:
   mz_zip_reader_extract_iter_state *iter_;
   std::uint64_t remaining_;
   char *buffer_;
+  ZipReader::Checkpoints *checkpoints_;
+  const bool inMemory_;
+  std::uint64_t nextCheckpoint_{0};
+
+  std::uint32_t inflate_(char *out, const std::uint64_t amount) {
+    if ((checkpoints_ != nullptr) && (iter_->out_buf_ofs >= nextCheckpoint_)) {
+      checkpoints_->add(capture(*iter_, inMemory_));
+      nextCheckpoint_ = iter_->out_buf_ofs + checkpoints_->interval();
+    }
+    const std::uint32_t result =
+        mz_zip_reader_extract_iter_read(iter_, out, amount);
+    remaining_ -= result;
+    return result;
+  }
 };
 
 class ZipWriterBuf final : public std::stringbuf {
@@ -59,8 +172,9 @@ private:
 
 class ZipReaderIstream final : public std::istream {
 public:
-  explicit ZipReaderIstream(mz_zip_reader_extract_iter_state *iter)
-      : ZipReaderIstream(new ZipReaderBuf(iter)) {}
+  ZipReaderIstream(mz_zip_reader_extract_iter_state *iter,
+                   ZipReader::Checkpoints *checkpoints, const bool inMemory)
+      : ZipReaderIstream(new ZipReaderBuf(iter, checkpoints, inMemory)) {}
   explicit ZipReaderIstream(ZipReaderBuf *sbuf)
       : std::istream(sbuf), sbuf_(sbuf) {}
   ~ZipReaderIstream() final { delete sbuf_; }
@@ -84,7 +198,7 @@ private:
 
 class ZipReader::Impl final {
 public:
-  Impl(const void *mem, const std::uint64_t size) {
+  Impl(const void *mem, const std::uint64_t size) : inMemory{true} {
     memset(&zip, 0, sizeof(zip));
     const mz_bool status = mz_zip_reader_init_mem(
         &zip, mem, size, MZ_ZIP_FLAG_DO_NOT_SORT_CENTRAL_DIRECTORY);
@@ -92,7 +206,7 @@ public:
       throw NoZipFileException("memory");
   }
 
-  explicit Impl(std::string data) : buffer(std::move(data)) {
+  explicit Impl(std::string data) : buffer(std::move(data)), inMemory{true} {
     memset(&zip, 0, sizeof(zip));
     const mz_bool status =
         mz_zip_reader_init_mem(&zip, buffer.data(), buffer.size(),
@@ -159,16 +273,63 @@ public:
     }
   }
 
-  std::unique_ptr<std::istream> read(const Path &path) noexcept {
+  std::unique_ptr<std::istream>
+  read(const Path &path, Checkpoints *checkpoints = nullptr) noexcept {
     auto iter =
         mz_zip_reader_extract_file_iter_new(&zip, path.string().c_str(), 0);
     if (iter == nullptr)
       return nullptr;
-    return std::make_unique<ZipReaderIstream>(iter);
+    return std::make_unique<ZipReaderIstream>(iter, checkpoints, inMemory);
+  }
+
+  std::unique_ptr<std::istream> read(const Path &path,
+                                     const Checkpoints &checkpoints,
+                                     const std::uint64_t offset) {
+    auto iter =
+        mz_zip_reader_extract_file_iter_new(&zip, path.string().c_str(), 0);
+    if (iter == nullptr)
+      return nullptr;
+    if (iter->file_stat.m_uncomp_size < offset) {
+      mz_zip_reader_extract_iter_free(iter);
+      return nullptr;
+    }
+    if (const auto checkpoint = checkpoints.find(offset); checkpoint)
+      restore(*iter, *checkpoint, inMemory);
+    auto result = std::make_unique<ZipReaderIstream>(iter, nullptr, inMemory);
+    result->ignore(offset - iter->out_buf_ofs);
+    return result;
+  }
+
+  std::string fingerprint() {
+    std::string serialized;
+    const mz_uint count = mz_zip_reader_get_num_files(&zip);
+    appendInt(serialized, count);
+    for (mz_uint i = 0; i < count; ++i) {
+      if (!mz_zip_reader_file_stat(&zip, i, &tmp_stat))
+        throw NoZipFileException("corrupted central directory");
+      serialized += tmp_stat.m_filename;
+      serialized += '\0';
+      appendInt(serialized, tmp_stat.m_crc32);
+      appendInt(serialized, tmp_stat.m_comp_size);
+      appendInt(serialized, tmp_stat.m_uncomp_size);
+      appendInt(serialized, tmp_stat.m_method);
+      // e.g. `mimetype`; stored entries need no inflate
+      if (tmp_stat.m_method == 0 &&
+          tmp_stat.m_uncomp_size <= fingerprint_content_size_) {
+        std::string content(tmp_stat.m_uncomp_size, '\0');
+        if (mz_zip_reader_extract_to_mem(&zip, i, content.data(),
+                                         content.size(), 0))
+          serialized += content;
+      }
+    }
+    return crypto::Util::hexEncode(
+        crypto::Util::sha256(serialized).substr(0, 16));
   }
 
   // private:
   std::string buffer;
+  // mem archives point into the archive instead of owning a read buffer
+  const bool inMemory{false};
   mz_zip_archive zip{};
   mz_zip_archive_file_stat tmp_stat{};
 };
@@ -244,6 +405,59 @@ std::unique_ptr<std::istream> ZipReader::read(const Path &path) const {
   return impl->read(path);
 }
 
+std::unique_ptr<std::istream>
+ZipReader::read(const Path &path, Checkpoints &checkpoints) const {
+  return impl->read(path, &checkpoints);
+}
+
+std::unique_ptr<std::istream>
+ZipReader::read(const Path &path, const Checkpoints &checkpoints,
+                const std::uint64_t offset) const {
+  return impl->read(path, checkpoints, offset);
+}
+
+std::string ZipReader::fingerprint() const { return impl->fingerprint(); }
+
+ZipReader::Checkpoints::Checkpoints(const std::uint64_t interval)
+    : interval_{interval} {}
+
+ZipReader::Checkpoints::~Checkpoints() = default;
+
+void ZipReader::Checkpoints::add(std::unique_ptr<Checkpoint> checkpoint) {
+  const auto it = std::upper_bound(
+      checkpoints_.begin(), checkpoints_.end(), checkpoint->state.out_buf_ofs,
+      [](const std::uint64_t offset, const auto &c) {
+        return offset < c->state.out_buf_ofs;
+      });
+  checkpoints_.insert(it, std::move(checkpoint));
+}
+
+const ZipReader::Checkpoints::Checkpoint *
+ZipReader::Checkpoints::find(const std::uint64_t offset) const noexcept {
+  const auto it = std::upper_bound(checkpoints_.begin(), checkpoints_.end(),
+                                   offset,
+                                   [](const std::uint64_t o, const auto &c) {
+                                     return o < c->state.out_buf_ofs;
+                                   });
+  if (it == checkpoints_.begin())
+    return nullptr;
+  return std::prev(it)->get();
+}
+
+void ZipReader::Checkpoints::retain(const std::vector<std::uint64_t> &offsets) {
+  std::vector<const Checkpoint *> keep;
+  for (auto &&offset : offsets) {
+    keep.push_back(find(offset));
+  }
+  checkpoints_.erase(
+      std::remove_if(checkpoints_.begin(), checkpoints_.end(),
+                     [&](const auto &c) {
+                       return std::find(keep.begin(), keep.end(), c.get()) ==
+                              keep.end();
+                     }),
+      checkpoints_.end());
+}
+
 ZipWriter::ZipWriter(const Path &path) : impl(std::make_unique<Impl>(path)) {}
 
 ZipWriter::~ZipWriter() = default;
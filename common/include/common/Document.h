@@ -29,6 +29,9 @@ public:
 
   virtual void edit(const std::string &diff) = 0;
 
+  // drops parsed parts kept between translations
+  virtual void releaseCache() noexcept = 0;
+
   virtual void save(const access::Path &path) const = 0;
   virtual void save(const access::Path &path,
                     const std::string &password) const = 0;
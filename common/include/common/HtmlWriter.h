@@ -0,0 +1,103 @@
+#ifndef ODR_COMMON_HTML_WRITER_H
+#define ODR_COMMON_HTML_WRITER_H
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace odr::common {
+
+// append-only buffer for the output of the translators. unlike
+// `std::ostream` an insertion is a plain append without sentry, locale or
+// virtual dispatch. numbers are formatted with `std::to_chars`, or `%g` where
+// the library lacks it for floating point, and look like the default
+// `std::ostream` formatting. the buffer is handed to the sink in blocks of
+// `blockSize` bytes and on destruction.
+class HtmlWriter final {
+public:
+  // collects the output in memory; see `str`
+  HtmlWriter();
+  explicit HtmlWriter(std::ostream &sink, std::size_t blockSize = 64 * 1024);
+  HtmlWriter(const HtmlWriter &) = delete;
+  HtmlWriter &operator=(const HtmlWriter &) = delete;
+  ~HtmlWriter();
+
+  void write(const char *data, const std::size_t size) {
+    buffer_.append(data, size);
+    if (buffer_.size() >= blockSize_)
+      flush();
+  }
+
+  HtmlWriter &operator<<(const char c) {
+    buffer_ += c;
+    return *this;
+  }
+  HtmlWriter &operator<<(const char *string) {
+    write(string, std::strlen(string));
+    return *this;
+  }
+  HtmlWriter &operator<<(const std::string &string) {
+    write(string.data(), string.size());
+    return *this;
+  }
+  HtmlWriter &operator<<(const std::string_view string) {
+    write(string.data(), string.size());
+    return *this;
+  }
+  HtmlWriter &operator<<(const bool value) {
+    return *this << (value ? '1' : '0');
+  }
+  template <typename T,
+            typename = std::enable_if_t<
+                std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                !std::is_same_v<T, char> && !std::is_same_v<T, signed char> &&
+                !std::is_same_v<T, unsigned char>>>
+  HtmlWriter &operator<<(const T value) {
+    char buffer[std::numeric_limits<T>::digits10 + 3];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    write(buffer, result.ptr - buffer);
+    return *this;
+  }
+  // same as the default `std::ostream` precision
+  HtmlWriter &operator<<(double value);
+  HtmlWriter &operator<<(const float value) {
+    return *this << static_cast<double>(value);
+  }
+
+  // escapes `&`, `<` and `>`
+  HtmlWriter &text(std::string_view string);
+  // escapes like `text` and additionally `"`
+  HtmlWriter &attribute(std::string_view string);
+  // base64 of `data` or of the rest of `in`; encoded in blocks straight into
+  // the buffer, so only a block of `in` is held at a time. throws
+  // `std::ios_base::failure` if `in` goes bad
+  HtmlWriter &base64(std::string_view data);
+  HtmlWriter &base64(std::istream &in);
+
+  // hands the buffered output to the sink
+  void flush();
+  // position to return to with `rollback`
+  std::uint64_t mark() const noexcept { return flushed_ + buffer_.size(); }
+  // drops the output written since `mark`; false if some of it was already
+  // handed to the sink and nothing was dropped
+  bool rollback(std::uint64_t mark) noexcept;
+  // output collected so far; only meaningful without sink
+  const std::string &str() const noexcept { return buffer_; }
+
+private:
+  std::ostream *sink_{nullptr};
+  std::size_t blockSize_;
+  std::string buffer_;
+  std::uint64_t flushed_{0};
+
+  void escape_(std::string_view string, bool quotes);
+};
+
+} // namespace odr::common
+
+#endif // ODR_COMMON_HTML_WRITER_H
@@ -0,0 +1,34 @@
+#ifndef ODR_COMMON_INLINE_STYLES_H
+#define ODR_COMMON_INLINE_STYLES_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace odr::common {
+
+class HtmlWriter;
+
+// declarations of `style` attributes hoisted into generated classes. equal
+// declarations share one class, so a document repeating the same direct
+// formatting on every element carries it once in its `<style>`.
+class InlineStyles final {
+public:
+  // writes the class carrying `declarations`
+  void write(const std::string &declarations, HtmlWriter &out);
+  void clear() noexcept;
+
+  // one rule per class. a single class selector, so the rules have to follow
+  // the css of the named styles to win over them like a `style` attribute
+  void css(HtmlWriter &out) const;
+
+private:
+  std::unordered_map<std::string, std::uint32_t> classes_;
+  // declarations by class
+  std::vector<const std::string *> declarations_;
+};
+
+} // namespace odr::common
+
+#endif // ODR_COMMON_INLINE_STYLES_H
@@ -0,0 +1,100 @@
+#ifndef ODR_COMMON_NAME_TABLE_H
+#define ODR_COMMON_NAME_TABLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace odr::common {
+
+template <typename Value> struct NameEntry {
+  std::string_view name;
+  Value value;
+};
+
+// perfect hash table from xml names to tokens built at compile time. the seed
+// of the hash is searched until every name gets a slot of its own, so a
+// lookup is one hash and one comparison without any allocation.
+template <typename Value, std::size_t N> class NameTable final {
+public:
+  constexpr explicit NameTable(const NameEntry<Value> (&entries)[N]) {
+    for (std::uint32_t seed = 0; seed < maxSeed_; ++seed) {
+      if (build_(entries, seed))
+        return;
+    }
+    // fails the constant evaluation
+    throw std::logic_error("no perfect hash found");
+  }
+
+  // value of `name` or `none` if the table does not contain it
+  constexpr Value find(const std::string_view name,
+                       const Value none) const noexcept {
+    const Slot &slot = slots_[hash_(name, seed_) & (size_ - 1)];
+    return (slot.used && (slot.name == name)) ? slot.value : none;
+  }
+
+private:
+  struct Slot {
+    std::string_view name;
+    Value value{};
+    bool used{false};
+  };
+
+  static constexpr std::uint32_t maxSeed_ = 1u << 16;
+
+  static constexpr std::size_t computeSize_() noexcept {
+    // four slots per name keep the seed search short
+    std::size_t result = 8;
+    while (result < 4 * N)
+      result *= 2;
+    return result;
+  }
+
+  static constexpr std::size_t size_ = computeSize_();
+
+  static constexpr std::uint32_t hash_(const std::string_view name,
+                                       const std::uint32_t seed) noexcept {
+    // fnv-1a followed by a final mix, the table only uses the low bits
+    std::uint32_t result = 2166136261u ^ seed;
+    for (const char c : name) {
+      result ^= static_cast<unsigned char>(c);
+      result *= 16777619u;
+    }
+    result ^= result >> 16;
+    result *= 0x7feb352du;
+    result ^= result >> 15;
+    return result;
+  }
+
+  constexpr bool build_(const NameEntry<Value> (&entries)[N],
+                        const std::uint32_t seed) {
+    for (auto &&slot : slots_)
+      slot = Slot{};
+    for (auto &&entry : entries) {
+      Slot &slot = slots_[hash_(entry.name, seed) & (size_ - 1)];
+      if (slot.used && (slot.name == entry.name))
+        throw std::logic_error("duplicate name");
+      if (slot.used)
+        return false;
+      slot = Slot{entry.name, entry.value, true};
+    }
+    seed_ = seed;
+    return true;
+  }
+
+  std::array<Slot, size_> slots_{};
+  std::uint32_t seed_{0};
+};
+
+// deduces the size of the table, e.g.
+// `constexpr auto table = nameTable<Token>({{"text:p", Token::P}, ...});`
+template <typename Value, std::size_t N>
+constexpr NameTable<Value, N> nameTable(const NameEntry<Value> (&entries)[N]) {
+  return NameTable<Value, N>(entries);
+}
+
+} // namespace odr::common
+
+#endif // ODR_COMMON_NAME_TABLE_H
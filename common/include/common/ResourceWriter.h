@@ -0,0 +1,44 @@
+#ifndef ODR_COMMON_RESOURCE_WRITER_H
+#define ODR_COMMON_RESOURCE_WRITER_H
+
+#include <access/Path.h>
+#include <string>
+#include <unordered_map>
+
+namespace odr::access {
+class ReadStorage;
+}
+
+namespace odr::common {
+
+// writes the images and media of a document as side files next to the html
+// instead of inlining them. a resource is named after the hash of its content
+// and keeps its extension, so documents can share `directory` without
+// overwriting each other and equal resources are stored once. written
+// through a temporary file, which is renamed once complete. see
+// `Config::resourcePath`
+class ResourceWriter final {
+public:
+  // `base` is the directory of the html which references the resources
+  ResourceWriter(std::string directory, std::string base);
+
+  // copies `path` of `storage` and returns its url relative to `base`
+  const std::string &write(const access::ReadStorage &storage,
+                           const access::Path &path);
+  // like above for content converted while translating, e.g. svm to svg
+  const std::string &write(const access::Path &path,
+                           const std::string &content);
+
+private:
+  std::string directory_;
+  std::string base_;
+  std::unordered_map<access::Path, std::string> urls_;
+
+  std::string file_(const std::string &name) const;
+  void publish_(const std::string &temp, const std::string &file) const;
+  std::string url_(const std::string &file) const;
+};
+
+} // namespace odr::common
+
+#endif // ODR_COMMON_RESOURCE_WRITER_H
@@ -2,12 +2,22 @@
 #define ODR_COMMON_STRINGUTIL_H
 
 #include <string>
+#include <string_view>
 
 namespace odr::common::StringUtil {
 bool startsWith(const std::string &string, const std::string &with);
 bool endsWith(const std::string &string, const std::string &with);
 void findAndReplaceAll(std::string &string, const std::string &search,
                        const std::string &replace);
+
+// position of the first character from `pos` on which has to be escaped in
+// xml text, or in attribute values if `attribute` is set. `npos` if there is
+// none. uses sse2 or avx2 where available.
+std::size_t findXmlSpecial(std::string_view string, std::size_t pos,
+                           bool attribute);
+// appends `string` to `out` with `&`, `<`, `>` and for attribute values also
+// `"` replaced by entities
+void escapeXml(std::string &out, std::string_view string, bool attribute);
 } // namespace odr::common::StringUtil
 
 #endif // ODR_COMMON_STRINGUTIL_H
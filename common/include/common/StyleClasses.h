@@ -0,0 +1,71 @@
+#ifndef ODR_COMMON_STYLE_CLASSES_H
+#define ODR_COMMON_STYLE_CLASSES_H
+
+#include <common/StyleSheet.h>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace odr::common {
+
+// `class` attribute values of all styles resolved once after the styles are
+// translated. a value is the escaped style name followed by its dependencies
+// in reverse order. the values lie back to back in one buffer, so emitting a
+// styled element is one lookup and one copy.
+class StyleClasses final {
+public:
+  void resolve(const std::unordered_map<std::string, std::list<std::string>>
+                   &dependencies);
+  // like `resolve`, but a style and its dependencies become one generated
+  // class. it carries the effective declarations of their simple rules
+  // `.a {}` and `.a.a {}` merged in source order; styles with equal
+  // declarations share it. other rules are kept together with their classes.
+  // falls back to `resolve` if that could change the cascade. see
+  // `Config::flattenStyles`
+  void flatten(const std::vector<const StyleSheet *> &styleSheets,
+               const std::unordered_map<std::string, std::list<std::string>>
+                   &dependencies);
+  void clear() noexcept;
+
+  // css of `flatten`; with `used` only the rules of the written styles
+  void css(HtmlWriter &out, const std::unordered_set<std::string> *used) const;
+
+  // writes the value of `name`; a style without value is written alone
+  void write(const std::string &name, HtmlWriter &out);
+
+  // every style written since `resolve` together with its transitive
+  // dependencies
+  std::unordered_set<std::string>
+  used(const std::unordered_map<std::string, std::list<std::string>>
+           &dependencies) const;
+
+private:
+  static constexpr std::uint32_t noRule_ = ~std::uint32_t(0);
+
+  struct Entry {
+    std::uint32_t begin;
+    std::uint32_t size;
+    bool used;
+    // generated class of `flatten`
+    std::uint32_t rule{noRule_};
+  };
+
+  std::string values_;
+  std::unordered_map<std::string, Entry> entries_;
+  // written styles without value
+  std::unordered_set<std::string> unknown_;
+
+  // rules of `flatten` which were not merged
+  StyleSheet rest_;
+  // merged declarations by generated class
+  std::vector<std::string> rules_;
+  // times the class is repeated in the selector to keep the specificity
+  std::size_t repeat_{1};
+};
+
+} // namespace odr::common
+
+#endif // ODR_COMMON_STYLE_CLASSES_H
@@ -0,0 +1,112 @@
+#ifndef ODR_COMMON_STYLE_SHEET_H
+#define ODR_COMMON_STYLE_SHEET_H
+
+#include <common/HtmlWriter.h>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace odr::access {
+class Path;
+class ReadStorage;
+} // namespace odr::access
+
+namespace odr::common {
+
+// css of one style part together with the class dependencies collected while
+// translating it
+struct StyleSheet {
+  std::string css;
+  std::unordered_map<std::string, std::list<std::string>> dependencies;
+
+  // runs `translate` with the output and dependencies of `context` redirected
+  // into a new style sheet
+  template <typename Context, typename Translate>
+  static StyleSheet compile(Context &context, Translate translate) {
+    StyleSheet result;
+    HtmlWriter css;
+    HtmlWriter *output = context.output;
+    auto dependencies = std::move(context.styleDependencies);
+    context.styleDependencies.clear();
+    context.output = &css;
+    translate();
+    context.output = output;
+    result.css = css.str();
+    result.dependencies = std::move(context.styleDependencies);
+    context.styleDependencies = std::move(dependencies);
+    return result;
+  }
+
+  // appends the dependencies to `context`
+  template <typename Context> void link(Context &context) const {
+    for (auto &&d : dependencies) {
+      auto &target = context.styleDependencies[d.first];
+      target.insert(target.end(), d.second.begin(), d.second.end());
+    }
+  }
+
+  // `css` without the rules whose selectors only name classes missing from
+  // `used`; rules without classes are kept
+  std::string prune(const std::unordered_set<std::string> &used) const;
+
+  struct Rule {
+    std::string_view selector;
+    std::string_view declarations;
+    // the whole rule including the whitespace in front of it
+    std::string_view text;
+  };
+
+  // top level rules of `css`
+  static std::vector<Rule> rules(std::string_view css);
+  // class names a match of `selector` needs; none for at-rules
+  static std::vector<std::string_view> classes(std::string_view selector);
+};
+
+// process wide cache of compiled style sheets. keyed by a hash of the style
+// part so that documents created from the same template share one style sheet
+class StyleSheetCache final {
+public:
+  typedef std::function<StyleSheet()> Compiler;
+
+  static StyleSheetCache &instance();
+  // `kind` separates translators reading the same part differently
+  static std::string key(const std::string &kind,
+                         const access::ReadStorage &storage,
+                         const access::Path &path);
+
+  explicit StyleSheetCache(std::size_t limit);
+
+  void setLimit(std::size_t entries);
+  std::size_t limit() const;
+  std::size_t size() const;
+
+  std::shared_ptr<const StyleSheet> get(const std::string &key,
+                                        const Compiler &compile);
+
+  void clear();
+
+private:
+  struct Entry {
+    std::shared_ptr<const StyleSheet> styleSheet;
+    std::list<std::string>::iterator lru;
+  };
+
+  mutable std::mutex mutex_;
+  std::size_t limit_;
+  std::unordered_map<std::string, Entry> entries_;
+  std::list<std::string> lru_;
+
+  void evict_();
+};
+
+} // namespace odr::common
+
+#endif // ODR_COMMON_STYLE_SHEET_H
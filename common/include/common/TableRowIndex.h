@@ -0,0 +1,40 @@
+#ifndef ODR_COMMON_TABLE_ROW_INDEX_H
+#define ODR_COMMON_TABLE_ROW_INDEX_H
+
+#include <cstdint>
+#include <vector>
+
+namespace odr::common {
+
+// sparse index from the rows of a table to the offsets of their elements
+// within the decompressed xml. an element may cover many rows, e.g. repeated
+// rows or a row group. only the first element after every `stride` rows is
+// kept, so reaching any row from its mark passes at most `stride` rows.
+class TableRowIndex final {
+public:
+  struct Mark {
+    std::uint32_t row;
+    std::uint64_t offset;
+  };
+
+  explicit TableRowIndex(std::uint32_t stride = 1024) noexcept;
+
+  // adds an element starting at `row` and `offset`. elements have to be added
+  // in document order; rows going backwards are ignored.
+  void add(std::uint32_t row, std::uint64_t offset);
+
+  bool empty() const noexcept { return marks_.empty(); }
+  // offset of the first row; everything before belongs to the table head
+  std::uint64_t begin() const noexcept;
+  // last mark at or before `row`; the index must not be empty
+  const Mark &find(std::uint32_t row) const noexcept;
+  const std::vector<Mark> &marks() const noexcept { return marks_; }
+
+private:
+  std::uint32_t stride_;
+  std::vector<Mark> marks_;
+};
+
+} // namespace odr::common
+
+#endif // ODR_COMMON_TABLE_ROW_INDEX_H
@@ -0,0 +1,179 @@
+#ifndef ODR_COMMON_TOKEN_DOM_H
+#define ODR_COMMON_TOKEN_DOM_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace odr::common {
+
+// compact read-only xml tree for translation. nodes live in one array and link
+// to their first child and next sibling by index. element and attribute names
+// are interned into tokens while parsing; text and attribute values are views
+// into the owned buffer, which is decoded in place. parses like
+// `XmlUtil::parse`: escapes resolved, line endings normalized, whitespace-only
+// text dropped, comments and processing instructions skipped. throws
+// `NotXmlException` on malformed input and `std::length_error` on 4 GiB of xml
+// or more.
+class TokenDom final {
+public:
+  using Token = std::uint32_t;
+
+  class Attribute final {
+  public:
+    Attribute() = default;
+
+    explicit operator bool() const noexcept { return dom_ != nullptr; }
+    Token token() const noexcept;
+    std::string_view name() const noexcept;
+    std::string_view as_string() const noexcept;
+    // `def` if the attribute does not exist; like pugixml otherwise
+    std::uint32_t as_uint(std::uint32_t def = 0) const noexcept;
+
+  private:
+    friend TokenDom;
+    const TokenDom *dom_{nullptr};
+    std::uint32_t index_{0};
+
+    Attribute(const TokenDom *dom, std::uint32_t index) noexcept
+        : dom_{dom}, index_{index} {}
+  };
+
+  class Node final {
+  public:
+    class Iterator final {
+    public:
+      Iterator(const TokenDom *dom, std::uint32_t index) noexcept
+          : dom_{dom}, index_{index} {}
+      Node operator*() const noexcept { return {dom_, index_}; }
+      Iterator &operator++() noexcept;
+      bool operator!=(const Iterator &other) const noexcept {
+        return index_ != other.index_;
+      }
+
+    private:
+      const TokenDom *dom_;
+      std::uint32_t index_;
+    };
+
+    class AttributeRange final {
+    public:
+      class Iterator final {
+      public:
+        Iterator(const TokenDom *dom, std::uint32_t index) noexcept
+            : dom_{dom}, index_{index} {}
+        Attribute operator*() const noexcept { return {dom_, index_}; }
+        Iterator &operator++() noexcept {
+          ++index_;
+          return *this;
+        }
+        bool operator!=(const Iterator &other) const noexcept {
+          return index_ != other.index_;
+        }
+
+      private:
+        const TokenDom *dom_;
+        std::uint32_t index_;
+      };
+
+      Iterator begin() const noexcept { return {dom_, begin_}; }
+      Iterator end() const noexcept { return {dom_, end_}; }
+
+    private:
+      friend Node;
+      const TokenDom *dom_;
+      std::uint32_t begin_;
+      std::uint32_t end_;
+    };
+
+    Node() = default;
+
+    explicit operator bool() const noexcept { return dom_ != nullptr; }
+    bool isElement() const noexcept;
+    bool isText() const noexcept;
+    bool isCdata() const noexcept;
+
+    // token and name of an element
+    Token token() const noexcept;
+    std::string_view name() const noexcept;
+    // content of a text or cdata node
+    std::string_view text() const noexcept;
+
+    Attribute attribute(std::string_view name) const noexcept;
+    Attribute attribute(Token token) const noexcept;
+    AttributeRange attributes() const noexcept;
+
+    Node first_child() const noexcept;
+    Node next_sibling() const noexcept;
+    // first child element with the given name
+    Node child(std::string_view name) const noexcept;
+
+    Iterator begin() const noexcept;
+    Iterator end() const noexcept { return {dom_, none_}; }
+
+  private:
+    friend TokenDom;
+    const TokenDom *dom_{nullptr};
+    std::uint32_t index_{0};
+
+    Node(const TokenDom *dom, std::uint32_t index) noexcept
+        : dom_{dom}, index_{index} {}
+  };
+
+  explicit TokenDom(std::string xml);
+  TokenDom(const TokenDom &) = delete;
+  TokenDom &operator=(const TokenDom &) = delete;
+
+  // document node; its children are the root element
+  Node document() const noexcept { return {this, 0}; }
+  // token of `name` or `noToken` if no element or attribute is called so
+  Token token(std::string_view name) const noexcept;
+  std::string_view name(Token token) const noexcept { return names_[token]; }
+
+  // bytes held by the tree including the buffer
+  std::size_t memory() const noexcept;
+
+  static constexpr Token noToken = 0;
+
+private:
+  static constexpr std::uint32_t none_ = 0;
+
+  enum class Kind : std::uint8_t {
+    DOCUMENT,
+    ELEMENT,
+    TEXT,
+    CDATA,
+  };
+
+  struct NodeData {
+    Kind kind;
+    // element name
+    Token name;
+    std::uint32_t firstChild;
+    std::uint32_t nextSibling;
+    // attribute range of an element, byte range of a text or cdata
+    std::uint32_t begin;
+    std::uint32_t size;
+  };
+
+  struct AttributeData {
+    Token name;
+    std::uint32_t begin;
+    std::uint32_t size;
+  };
+
+  std::string buffer_;
+  std::vector<NodeData> nodes_;
+  std::vector<AttributeData> attributes_;
+  std::vector<std::string_view> names_;
+  std::unordered_map<std::string_view, Token> tokens_;
+
+  Token intern_(std::string_view name);
+  void parse_();
+};
+
+} // namespace odr::common
+
+#endif // ODR_COMMON_TOKEN_DOM_H
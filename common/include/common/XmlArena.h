@@ -0,0 +1,89 @@
+#ifndef ODR_COMMON_XML_ARENA_H
+#define ODR_COMMON_XML_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace odr::common {
+
+struct XmlArenaInUseException final : public std::logic_error {
+  XmlArenaInUseException() : std::logic_error("xml arena still in use") {}
+};
+
+// bump allocator for pugixml. while a `Scope` is active, every pugixml
+// allocation on that thread is served from the arena; frees are no-ops apart
+// from bookkeeping. `reset` rewinds to the first block in O(1) and keeps the
+// memory for the next request, so a worker stops churning the heap.
+//
+// documents allocated from an arena have to be destroyed before it is reset
+// or destroyed. pugixml allocations outside of any scope go to the heap.
+class XmlArena final {
+public:
+  struct Stats {
+    // bytes handed out since the last reset
+    std::uint64_t used{0};
+    // highest `used` ever seen
+    std::uint64_t peak{0};
+    // bytes of all blocks owned by the arena
+    std::uint64_t reserved{0};
+    // bytes served from blocks kept over a reset
+    std::uint64_t reused{0};
+  };
+
+  // routes pugixml allocations through the arena hooks by replacing the
+  // process-wide pugixml memory functions once. called by every arena and
+  // `XmlUtil::parse`; blocks allocated before go back to the previous
+  // deallocation function.
+  static void installHooks();
+
+  static XmlArena *current() noexcept;
+
+  // makes `arena` the current arena of this thread until destruction
+  class Scope final {
+  public:
+    explicit Scope(XmlArena &arena) noexcept;
+    Scope(const Scope &) = delete;
+    ~Scope();
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    XmlArena *previous_;
+  };
+
+  explicit XmlArena(std::size_t blockSize = 1024 * 1024);
+  XmlArena(const XmlArena &) = delete;
+  ~XmlArena();
+  XmlArena &operator=(const XmlArena &) = delete;
+
+  void *allocate(std::size_t size);
+  void deallocate(void *) noexcept;
+
+  // throws `XmlArenaInUseException` if allocations are still alive
+  void reset();
+
+  // number of allocations which were not deallocated yet
+  std::uint64_t live() const noexcept { return live_; }
+  Stats stats() const noexcept { return stats_; }
+
+private:
+  struct Block {
+    char *data;
+    std::size_t size;
+  };
+
+  const std::size_t blockSize_;
+  std::vector<Block> blocks_;
+  std::size_t block_{0};
+  std::size_t offset_{0};
+  // blocks which existed at the last reset
+  std::size_t retained_{0};
+  std::atomic<std::uint64_t> live_{0};
+  Stats stats_;
+};
+
+} // namespace odr::common
+
+#endif // ODR_COMMON_XML_ARENA_H
@@ -0,0 +1,58 @@
+#ifndef ODR_COMMON_XML_CACHE_H
+#define ODR_COMMON_XML_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace pugi {
+class xml_document;
+} // namespace pugi
+
+namespace odr::access {
+class Path;
+class ReadStorage;
+} // namespace odr::access
+
+namespace odr::common {
+
+// parsed xml parts of one storage kept between translations. least recently
+// used parts are dropped once the estimated memory exceeds the limit; parts
+// still referenced by a caller stay alive until released there.
+class XmlCache final {
+public:
+  explicit XmlCache(const access::ReadStorage *storage = nullptr) noexcept;
+
+  // drops all parts parsed so far, even if `storage` is the same pointer
+  void setStorage(const access::ReadStorage *storage) noexcept;
+  // zero disables caching
+  void setLimit(std::uint64_t bytes) noexcept;
+
+  std::uint64_t limit() const noexcept { return limit_; }
+  std::uint64_t size() const noexcept { return size_; }
+
+  std::shared_ptr<pugi::xml_document> get(const access::Path &path);
+
+  void clear() noexcept;
+
+private:
+  struct Entry {
+    std::shared_ptr<pugi::xml_document> document;
+    std::uint64_t size;
+    std::list<std::string>::iterator lru;
+  };
+
+  const access::ReadStorage *storage_;
+  std::uint64_t limit_{0};
+  std::uint64_t size_{0};
+  std::unordered_map<std::string, Entry> entries_;
+  std::list<std::string> lru_;
+
+  void evict_() noexcept;
+};
+
+} // namespace odr::common
+
+#endif // ODR_COMMON_XML_CACHE_H
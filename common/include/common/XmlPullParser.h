@@ -0,0 +1,92 @@
+#ifndef ODR_COMMON_XML_PULL_PARSER_H
+#define ODR_COMMON_XML_PULL_PARSER_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace pugi {
+class xml_node;
+} // namespace pugi
+
+namespace odr::common {
+
+// incremental xml tokenizer reading from a stream in chunks. only the current
+// token and the names of the open elements are kept in memory. text is
+// decoded like `XmlUtil::parse` does it: escapes resolved, line endings
+// normalized and whitespace-only text dropped. processing instructions,
+// comments and doctype are skipped. throws `NotXmlException` on malformed
+// input.
+class XmlPullParser final {
+public:
+  enum class Event {
+    START_ELEMENT,
+    END_ELEMENT,
+    TEXT,
+    CDATA,
+    END_DOCUMENT,
+  };
+
+  struct Attribute {
+    std::string name;
+    std::string value;
+  };
+
+  explicit XmlPullParser(std::istream &in, std::size_t chunkSize = 64 * 1024);
+
+  Event next();
+
+  Event event() const noexcept { return event_; }
+  // element name for start and end events
+  const std::string &name() const noexcept { return name_; }
+  // attributes of a start event
+  const std::vector<Attribute> &attributes() const noexcept {
+    return attributes_;
+  }
+  const char *attribute(const std::string &name) const noexcept;
+  // text of text and cdata events
+  const std::string &text() const noexcept { return text_; }
+  // number of open elements including the current start element
+  std::uint32_t depth() const noexcept { return stack_.size(); }
+  // offset of the current token within the stream
+  std::uint64_t offset() const noexcept { return offset_; }
+  // offset right after the current token
+  std::uint64_t endOffset() const noexcept { return base_ + pos_; }
+
+  // consumes the rest of the current start element including its end
+  void skip();
+  // appends the current start element with its attributes and without
+  // children to `parent`
+  pugi::xml_node append(pugi::xml_node parent) const;
+  // appends the current start element including its subtree to `parent` and
+  // consumes it
+  pugi::xml_node copy(pugi::xml_node parent);
+
+private:
+  std::istream &in_;
+  const std::size_t chunkSize_;
+  std::string buffer_;
+  std::size_t pos_{0};
+  // stream offset of `buffer_[0]`
+  std::uint64_t base_{0};
+  bool eof_{false};
+
+  Event event_{Event::END_DOCUMENT};
+  std::string name_;
+  std::vector<Attribute> attributes_;
+  std::string text_;
+  std::uint64_t offset_{0};
+  std::vector<std::string> stack_;
+  bool selfClosing_{false};
+
+  bool fill_();
+  std::size_t find_(const char *pattern);
+  std::size_t findTagEnd_();
+  void parseStartTag_(std::size_t end);
+  void parseEndTag_(std::size_t end);
+};
+
+} // namespace odr::common
+
+#endif // ODR_COMMON_XML_PULL_PARSER_H
@@ -0,0 +1,95 @@
+#include <common/HtmlWriter.h>
+#include <common/StringUtil.h>
+#include <crypto/Base64.h>
+#include <cstdio>
+#include <istream>
+#include <ostream>
+
+namespace odr::common {
+
+namespace {
+// a multiple of 3, so the blocks are encoded without padding in between
+constexpr std::size_t base64BlockSize = 3 * 16 * 1024;
+} // namespace
+
+HtmlWriter::HtmlWriter()
+    : blockSize_{std::numeric_limits<std::size_t>::max()} {}
+
+HtmlWriter::HtmlWriter(std::ostream &sink, const std::size_t blockSize)
+    : sink_{&sink}, blockSize_{blockSize} {
+  buffer_.reserve(blockSize);
+}
+
+HtmlWriter::~HtmlWriter() { flush(); }
+
+HtmlWriter &HtmlWriter::operator<<(const double value) {
+  // `%g` with precision 6 is what `std::ostream` uses by default
+  char buffer[32];
+#ifdef __cpp_lib_to_chars
+  const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value,
+                                    std::chars_format::general, 6);
+  write(buffer, result.ptr - buffer);
+#else
+  // libstdc++ before 11 and libc++ lack floating point `std::to_chars`
+  const int size = std::snprintf(buffer, sizeof(buffer), "%g", value);
+  write(buffer, size);
+#endif
+  return *this;
+}
+
+HtmlWriter &HtmlWriter::text(const std::string_view string) {
+  escape_(string, false);
+  return *this;
+}
+
+HtmlWriter &HtmlWriter::attribute(const std::string_view string) {
+  escape_(string, true);
+  return *this;
+}
+
+HtmlWriter &HtmlWriter::base64(const std::string_view data) {
+  for (std::size_t pos = 0; pos < data.size(); pos += base64BlockSize) {
+    const auto block = data.substr(pos, base64BlockSize);
+    const std::size_t begin = buffer_.size();
+    buffer_.resize(begin + crypto::Base64::encodedSize(block.size()));
+    crypto::Base64::encode(block, buffer_.data() + begin);
+    if (buffer_.size() >= blockSize_)
+      flush();
+  }
+  return *this;
+}
+
+HtmlWriter &HtmlWriter::base64(std::istream &in) {
+  std::string block(base64BlockSize, '\0');
+  while (in) {
+    in.read(block.data(), block.size());
+    base64(std::string_view(block.data(), in.gcount()));
+  }
+  // the stream swallows what its buffer throws
+  if (in.bad())
+    throw std::ios_base::failure("base64 input failed");
+  return *this;
+}
+
+void HtmlWriter::flush() {
+  if (sink_ == nullptr || buffer_.empty())
+    return;
+  sink_->write(buffer_.data(), buffer_.size());
+  flushed_ += buffer_.size();
+  buffer_.clear();
+}
+
+bool HtmlWriter::rollback(const std::uint64_t mark) noexcept {
+  if (mark < flushed_)
+    return false;
+  buffer_.resize(mark - flushed_);
+  return true;
+}
+
+void HtmlWriter::escape_(const std::string_view string, const bool quotes) {
+  StringUtil::escapeXml(buffer_, string, quotes);
+  if (buffer_.size() >= blockSize_)
+    flush();
+}
+
+} // namespace odr::common
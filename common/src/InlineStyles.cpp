@@ -0,0 +1,32 @@
+#include <common/HtmlWriter.h>
+#include <common/InlineStyles.h>
+
+namespace odr::common {
+
+namespace {
+constexpr char inlinePrefix[] = "odr-i";
+}
+
+void InlineStyles::write(const std::string &declarations, HtmlWriter &out) {
+  auto it = classes_.find(declarations);
+  if (it == classes_.end()) {
+    it = classes_
+             .emplace(declarations,
+                      static_cast<std::uint32_t>(declarations_.size()))
+             .first;
+    declarations_.push_back(&it->first);
+  }
+  out << inlinePrefix << it->second;
+}
+
+void InlineStyles::clear() noexcept {
+  classes_.clear();
+  declarations_.clear();
+}
+
+void InlineStyles::css(HtmlWriter &out) const {
+  for (std::uint32_t i = 0; i < declarations_.size(); ++i)
+    out << "." << inlinePrefix << i << " {" << *declarations_[i] << "}\n";
+}
+
+} // namespace odr::common
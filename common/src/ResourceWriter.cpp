@@ -0,0 +1,155 @@
+#include <access/Storage.h>
+#include <access/StreamUtil.h>
+#include <cctype>
+#include <common/ResourceWriter.h>
+#include <crypto/CryptoUtil.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace odr::common {
+
+namespace {
+constexpr const char *tempPrefix = ".tmp-";
+
+std::string randomSuffix() {
+  static thread_local std::mt19937_64 generator{std::random_device{}()};
+  std::string bytes(8, '\0');
+  const std::uint64_t value = generator();
+  std::memcpy(bytes.data(), &value, sizeof(value));
+  return crypto::Util::hexEncode(bytes);
+}
+
+// 128 bit are plenty to identify a resource
+std::string name(const std::string &sha256, const access::Path &path) {
+  std::string result = crypto::Util::hexEncode(sha256.substr(0, 16));
+  const std::string extension = path.extension();
+  for (auto &&c : extension) {
+    if (!std::isalnum(static_cast<unsigned char>(c)) && (c != '.'))
+      return result;
+  }
+  if (!extension.empty())
+    result += "." + extension;
+  return result;
+}
+} // namespace
+
+ResourceWriter::ResourceWriter(std::string directory, std::string base)
+    : directory_{std::move(directory)}, base_{std::move(base)} {}
+
+const std::string &ResourceWriter::write(const access::ReadStorage &storage,
+                                         const access::Path &path) {
+  if (const auto it = urls_.find(path); it != urls_.end())
+    return it->second;
+
+  const auto in = storage.read(path);
+  if (!in)
+    throw access::FileNotFoundException(path.string());
+  fs::create_directories(directory_);
+  const std::string temp =
+      (fs::path(directory_) / (tempPrefix + randomSuffix())).string();
+  try {
+    {
+      std::ofstream out(temp, std::ios::binary);
+      if (!out.is_open())
+        throw access::FileNotCreatedException(temp);
+      // inflated block by block; the resource is never held as a whole
+      access::StreamUtil::pipe(*in, out);
+      if (in->bad())
+        throw std::ios_base::failure("resource input failed");
+      out.close();
+      if (!out)
+        throw access::FileNotCreatedException(temp);
+    }
+    std::ifstream written(temp, std::ios::binary);
+    const std::string file = file_(name(crypto::Util::sha256(written), path));
+    written.close();
+    publish_(temp, file);
+    return urls_[path] = url_(file);
+  } catch (...) {
+    std::error_code ec;
+    fs::remove(temp, ec);
+    throw;
+  }
+}
+
+const std::string &ResourceWriter::write(const access::Path &path,
+                                         const std::string &content) {
+  if (const auto it = urls_.find(path); it != urls_.end())
+    return it->second;
+
+  const std::string file = file_(name(crypto::Util::sha256(content), path));
+  std::error_code ec;
+  if (!fs::is_regular_file(file, ec)) {
+    fs::create_directories(directory_);
+    const std::string temp =
+        (fs::path(directory_) / (tempPrefix + randomSuffix())).string();
+    std::ofstream out(temp, std::ios::binary);
+    if (!out.is_open())
+      throw access::FileNotCreatedException(temp);
+    out.write(content.data(), content.size());
+    out.close();
+    if (!out) {
+      fs::remove(temp, ec);
+      throw access::FileNotCreatedException(temp);
+    }
+    publish_(temp, file);
+  }
+  return urls_[path] = url_(file);
+}
+
+std::string ResourceWriter::file_(const std::string &name) const {
+  return (fs::path(directory_) / name).string();
+}
+
+void ResourceWriter::publish_(const std::string &temp,
+                              const std::string &file) const {
+  // equal names mean equal content, an existing file stays
+  std::error_code ec;
+  if (fs::is_regular_file(file, ec)) {
+    fs::remove(temp, ec);
+    return;
+  }
+  fs::rename(temp, file, ec);
+  if (ec) {
+    fs::remove(temp, ec);
+    throw access::FileNotCreatedException(file);
+  }
+}
+
+std::string ResourceWriter::url_(const std::string &file) const {
+  const auto absolute = fs::absolute(file).lexically_normal();
+  auto relative = absolute.lexically_relative(
+      fs::absolute(base_.empty() ? "." : base_).lexically_normal());
+  if (relative.empty())
+    relative = absolute;
+
+  std::string result;
+  for (auto &&c : relative.generic_string()) {
+    switch (c) {
+    case ' ':
+      result += "%20";
+      break;
+    case '#':
+      result += "%23";
+      break;
+    case '%':
+      result += "%25";
+      break;
+    case '?':
+      result += "%3F";
+      break;
+    default:
+      result += c;
+    }
+  }
+  return result;
+}
+
+} // namespace odr::common
@@ -1,7 +1,100 @@
+#include <XmlSpecialFinders.h>
 #include <common/StringUtil.h>
+#include <cstdint>
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#include <immintrin.h>
+#define ODR_SIMD_X86
+// Apple clang before 12 cannot link `__builtin_cpu_supports`
+#if !defined(__apple_build_version__) || (__apple_build_version__ >= 12000000)
+#define ODR_CPU_DISPATCH
+#endif
+#endif
 
 namespace odr::common {
 
+namespace {
+bool isXmlSpecial(const char c, const bool attribute) {
+  return (c == '&') || (c == '<') || (c == '>') || (attribute && (c == '"'));
+}
+
+std::size_t findXmlSpecialScalar(const char *data, std::size_t pos,
+                                 const std::size_t size, const bool attribute) {
+  for (; pos < size; ++pos) {
+    if (isXmlSpecial(data[pos], attribute))
+      return pos;
+  }
+  return std::string_view::npos;
+}
+
+#ifdef ODR_SIMD_X86
+// outside of attributes `"` is replaced by a second `&` to avoid a branch
+std::size_t findXmlSpecialSse2(const char *data, std::size_t pos,
+                               const std::size_t size, const bool attribute) {
+  const __m128i amp = _mm_set1_epi8('&');
+  const __m128i lt = _mm_set1_epi8('<');
+  const __m128i gt = _mm_set1_epi8('>');
+  const __m128i quot = _mm_set1_epi8(attribute ? '"' : '&');
+  for (; pos + 16 <= size; pos += 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+    const __m128i match =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, amp),
+                                  _mm_cmpeq_epi8(chunk, lt)),
+                     _mm_or_si128(_mm_cmpeq_epi8(chunk, gt),
+                                  _mm_cmpeq_epi8(chunk, quot)));
+    const int mask = _mm_movemask_epi8(match);
+    if (mask != 0)
+      return pos + __builtin_ctz(mask);
+  }
+  return findXmlSpecialScalar(data, pos, size, attribute);
+}
+
+// unused where neither the cpu can be asked nor the build targets avx2
+__attribute__((target("avx2"), unused)) std::size_t
+findXmlSpecialAvx2(const char *data, std::size_t pos, const std::size_t size,
+                   const bool attribute) {
+  const __m256i amp = _mm256_set1_epi8('&');
+  const __m256i lt = _mm256_set1_epi8('<');
+  const __m256i gt = _mm256_set1_epi8('>');
+  const __m256i quot = _mm256_set1_epi8(attribute ? '"' : '&');
+  for (; pos + 32 <= size; pos += 32) {
+    const __m256i chunk =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+    const __m256i match =
+        _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, amp),
+                                        _mm256_cmpeq_epi8(chunk, lt)),
+                        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, gt),
+                                        _mm256_cmpeq_epi8(chunk, quot)));
+    const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(match));
+    if (mask != 0)
+      return pos + __builtin_ctz(mask);
+  }
+  return findXmlSpecialSse2(data, pos, size, attribute);
+}
+#endif
+
+StringUtil::XmlSpecialFinders detectXmlSpecialFinders() {
+  StringUtil::XmlSpecialFinders result{findXmlSpecialScalar, nullptr, nullptr};
+#ifdef ODR_SIMD_X86
+  result.sse2 = findXmlSpecialSse2;
+#if defined(ODR_CPU_DISPATCH)
+  if (__builtin_cpu_supports("avx2"))
+    result.avx2 = findXmlSpecialAvx2;
+#elif defined(__AVX2__)
+  // only what the build targets
+  result.avx2 = findXmlSpecialAvx2;
+#endif
+#endif
+  return result;
+}
+} // namespace
+
+const StringUtil::XmlSpecialFinders &StringUtil::xmlSpecialFinders() {
+  static const XmlSpecialFinders result = detectXmlSpecialFinders();
+  return result;
+}
+
 bool StringUtil::startsWith(const std::string &string,
                             const std::string &with) {
   return string.rfind(with, 0) == 0;
@@ -23,4 +116,46 @@ void StringUtil::findAndReplaceAll(std::string &string,
   }
 }
 
+std::size_t StringUtil::findXmlSpecial(const std::string_view string,
+                                       const std::size_t pos,
+                                       const bool attribute) {
+  static const XmlSpecialFinder find = [] {
+    const XmlSpecialFinders &available = xmlSpecialFinders();
+    if (available.avx2 != nullptr)
+      return available.avx2;
+    if (available.sse2 != nullptr)
+      return available.sse2;
+    return available.scalar;
+  }();
+  return find(string.data(), pos, string.size(), attribute);
+}
+
+void StringUtil::escapeXml(std::string &out, const std::string_view string,
+                           const bool attribute) {
+  // copy the runs between special characters in one go
+  std::size_t begin = 0;
+  while (true) {
+    const std::size_t pos = findXmlSpecial(string, begin, attribute);
+    if (pos == std::string_view::npos)
+      break;
+    out.append(string.data() + begin, pos - begin);
+    switch (string[pos]) {
+    case '&':
+      out.append("&amp;");
+      break;
+    case '<':
+      out.append("&lt;");
+      break;
+    case '>':
+      out.append("&gt;");
+      break;
+    default:
+      out.append("&quot;");
+      break;
+    }
+    begin = pos + 1;
+  }
+  out.append(string.data() + begin, string.size() - begin);
+}
+
 } // namespace odr::common
@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <common/HtmlWriter.h>
+#include <common/StringUtil.h>
+#include <common/StyleClasses.h>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+namespace odr::common {
+
+namespace {
+constexpr char flatPrefix[] = "odr-s";
+
+std::string_view trim(std::string_view string) {
+  const auto begin = string.find_first_not_of(" \t\r\n");
+  if (begin == std::string_view::npos)
+    return {};
+  const auto end = string.find_last_not_of(" \t\r\n");
+  return string.substr(begin, end - begin + 1);
+}
+
+// `.a` or `.a.a`, the shape of the rules the style translators write
+bool isSimple(const std::string_view selector,
+              const std::vector<std::string_view> &classes) {
+  if (classes.empty())
+    return false;
+  std::size_t size = 0;
+  for (auto &&c : classes) {
+    if (c != classes.front())
+      return false;
+    size += 1 + c.size();
+  }
+  return trim(selector).size() == size;
+}
+
+using Specificity = std::array<std::size_t, 3>;
+
+std::size_t nameEnd(const std::string_view selector, std::size_t i) {
+  while ((i < selector.size()) &&
+         (std::strchr(" \t\r\n.#:,>+~[](){", selector[i]) == nullptr))
+    ++i;
+  return i;
+}
+
+std::size_t skipPast(const std::string_view selector, const char c,
+                     const std::size_t i) {
+  const auto found = selector.find(c, i);
+  return found == std::string_view::npos ? selector.size() : found + 1;
+}
+
+// ids, classes and elements of each selector in a selector list. arguments
+// like those of `:not(.a)` are not counted
+std::vector<Specificity> specificities(const std::string_view selectors) {
+  std::vector<Specificity> result(1);
+  for (std::size_t i = 0; i < selectors.size();) {
+    const char c = selectors[i];
+    auto &specificity = result.back();
+    if (c == ',') {
+      result.emplace_back();
+      ++i;
+    } else if (c == '#') {
+      ++specificity[0];
+      i = nameEnd(selectors, i + 1);
+    } else if (c == '.') {
+      ++specificity[1];
+      i = nameEnd(selectors, i + 1);
+    } else if (c == '[') {
+      ++specificity[1];
+      i = skipPast(selectors, ']', i);
+    } else if (c == ':') {
+      const bool element =
+          (i + 1 < selectors.size()) && (selectors[i + 1] == ':');
+      const auto begin = i + (element ? 2 : 1);
+      i = nameEnd(selectors, begin);
+      const auto name = selectors.substr(begin, i - begin);
+      if (element || (name == "before") || (name == "after") ||
+          (name == "first-line") || (name == "first-letter"))
+        ++specificity[2];
+      else
+        ++specificity[1];
+      if ((i < selectors.size()) && (selectors[i] == '('))
+        i = skipPast(selectors, ')', i);
+    } else if (std::isalpha(static_cast<unsigned char>(c))) {
+      ++specificity[2];
+      i = nameEnd(selectors, i);
+    } else {
+      ++i;
+    }
+  }
+  return result;
+}
+
+// whether a rule of `css` could match with a specificity from `.a` repeated
+// `low` times up to `high` times
+bool ties(const std::string_view css, const std::size_t low,
+          const std::size_t high) {
+  for (auto &&rule : StyleSheet::rules(css)) {
+    if (trim(rule.selector).substr(0, 1) == "@") {
+      // only conditional at-rules like `@media` nest rules
+      if ((rule.declarations.find('{') != std::string_view::npos) &&
+          ties(rule.declarations, low, high))
+        return true;
+      continue;
+    }
+    for (auto &&s : specificities(rule.selector)) {
+      if ((s >= Specificity{0, low, 0}) && (s <= Specificity{0, high, 0}))
+        return true;
+    }
+  }
+  return false;
+}
+
+// joins the declarations and drops the ones overridden later on. a
+// shorthand between two declarations of a property does not matter, the
+// last one wins over both
+std::string merge(const std::vector<std::string_view> &declarations) {
+  std::vector<std::pair<std::string_view, std::string_view>> merged;
+  std::unordered_map<std::string_view, std::size_t> properties;
+  for (auto &&d : declarations) {
+    std::size_t begin = 0;
+    char quote = '\0';
+    for (std::size_t i = 0; i <= d.size(); ++i) {
+      const char c = i < d.size() ? d[i] : ';';
+      if (quote != '\0') {
+        if (c == quote)
+          quote = '\0';
+        continue;
+      }
+      if ((c == '"') || (c == '\'')) {
+        quote = c;
+        continue;
+      }
+      if (c != ';')
+        continue;
+      const auto declaration = trim(d.substr(begin, i - begin));
+      begin = i + 1;
+      const auto colon = declaration.find(':');
+      if (colon == std::string_view::npos)
+        continue;
+      const auto property = trim(declaration.substr(0, colon));
+      const auto it = properties.find(property);
+      if (it != properties.end())
+        merged[it->second].second = {};
+      properties[property] = merged.size();
+      merged.emplace_back(property, declaration);
+    }
+  }
+
+  std::string result;
+  for (auto &&m : merged) {
+    if (m.second.empty())
+      continue;
+    result += m.second;
+    result += ';';
+  }
+  return result;
+}
+} // namespace
+
+void StyleClasses::resolve(
+    const std::unordered_map<std::string, std::list<std::string>>
+        &dependencies) {
+  clear();
+  entries_.reserve(dependencies.size());
+  for (auto &&d : dependencies) {
+    const auto begin = static_cast<std::uint32_t>(values_.size());
+    StringUtil::escapeXml(values_, d.first, true);
+    for (auto i = d.second.rbegin(); i != d.second.rend(); ++i) {
+      values_ += ' ';
+      StringUtil::escapeXml(values_, *i, true);
+    }
+    entries_[d.first] = {
+        begin, static_cast<std::uint32_t>(values_.size()) - begin, false};
+  }
+}
+
+void StyleClasses::flatten(
+    const std::vector<const StyleSheet *> &styleSheets,
+    const std::unordered_map<std::string, std::list<std::string>>
+        &dependencies) {
+  clear();
+
+  // simple rules by class in source order
+  std::vector<std::string_view> declarations;
+  // times the class is repeated in the selector of each simple rule
+  std::vector<std::size_t> repeats;
+  std::unordered_map<std::string_view, std::vector<std::uint32_t>> simple;
+  // classes named by the other rules
+  std::unordered_set<std::string_view> kept;
+  for (auto &&styleSheet : styleSheets) {
+    for (auto &&rule : StyleSheet::rules(styleSheet->css)) {
+      const auto classes = StyleSheet::classes(rule.selector);
+      if (!isSimple(rule.selector, classes)) {
+        rest_.css += rule.text;
+        kept.insert(classes.begin(), classes.end());
+        continue;
+      }
+      simple[classes.front()].push_back(
+          static_cast<std::uint32_t>(declarations.size()));
+      declarations.push_back(rule.declarations);
+      repeats.push_back(classes.size());
+      repeat_ = std::max(repeat_, classes.size());
+    }
+  }
+
+  // the generated classes come after the other rules, with the specificity
+  // of the most specific simple rule. against another rule that matches the
+  // same element they win and lose like the simple rules did, unless its
+  // specificity lies between the least and the most specific simple rule;
+  // there source order decided before. the style translators never write
+  // such rules, for anything else the styles stay as they are
+  if (!repeats.empty() &&
+      ties(rest_.css, *std::min_element(repeats.begin(), repeats.end()),
+           repeat_)) {
+    std::string css;
+    for (auto &&styleSheet : styleSheets)
+      css += styleSheet->css;
+    resolve(dependencies);
+    rest_.css = std::move(css);
+    return;
+  }
+
+  std::unordered_map<std::string, std::uint32_t> rules;
+  const auto add = [&](const std::string &name,
+                       const std::list<std::string> *dependencies) {
+    std::vector<std::uint32_t> indices;
+    std::string classes;
+    const auto collect = [&](const std::string_view c) {
+      if (const auto it = simple.find(c); it != simple.end())
+        indices.insert(indices.end(), it->second.begin(), it->second.end());
+      if (kept.find(c) != kept.end()) {
+        classes += ' ';
+        StringUtil::escapeXml(classes, c, true);
+      }
+    };
+    collect(name);
+    if (dependencies != nullptr) {
+      for (auto i = dependencies->rbegin(); i != dependencies->rend(); ++i)
+        collect(*i);
+    }
+    // more specific rules win regardless of source order
+    std::sort(indices.begin(), indices.end(), [&](const auto a, const auto b) {
+      return std::make_pair(repeats[a], a) < std::make_pair(repeats[b], b);
+    });
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    std::vector<std::string_view> effective;
+    for (auto &&i : indices)
+      effective.push_back(declarations[i]);
+
+    Entry entry{static_cast<std::uint32_t>(values_.size()), 0, false};
+    if (auto merged = merge(effective); !merged.empty()) {
+      const auto it = rules.emplace(std::move(merged), rules_.size()).first;
+      if (it->second == rules_.size())
+        rules_.push_back(it->first);
+      entry.rule = it->second;
+      values_ += flatPrefix;
+      values_ += std::to_string(entry.rule);
+    } else if (!classes.empty()) {
+      classes.erase(0, 1);
+    }
+    values_ += classes;
+    entry.size = static_cast<std::uint32_t>(values_.size()) - entry.begin;
+    entries_[name] = entry;
+  };
+
+  // sorted, so that the generated classes do not depend on hashing
+  std::vector<std::string> names;
+  names.reserve(dependencies.size() + simple.size());
+  for (auto &&d : dependencies)
+    names.push_back(d.first);
+  for (auto &&s : simple) {
+    if (dependencies.find(std::string(s.first)) == dependencies.end())
+      names.emplace_back(s.first);
+  }
+  std::sort(names.begin(), names.end());
+  entries_.reserve(names.size());
+  for (auto &&name : names) {
+    const auto it = dependencies.find(name);
+    add(name, it == dependencies.end() ? nullptr : &it->second);
+  }
+}
+
+void StyleClasses::clear() noexcept {
+  values_.clear();
+  entries_.clear();
+  unknown_.clear();
+  rest_ = {};
+  rules_.clear();
+  repeat_ = 1;
+}
+
+void StyleClasses::css(HtmlWriter &out,
+                       const std::unordered_set<std::string> *used) const {
+  out << (used == nullptr ? rest_.css : rest_.prune(*used));
+
+  std::vector<bool> written(rules_.size(), used == nullptr);
+  for (auto &&e : entries_) {
+    if (e.second.used && (e.second.rule != noRule_))
+      written[e.second.rule] = true;
+  }
+  for (std::uint32_t i = 0; i < rules_.size(); ++i) {
+    if (!written[i])
+      continue;
+    for (std::size_t j = 0; j < repeat_; ++j)
+      out << "." << flatPrefix << i;
+    out << " {" << rules_[i] << "}\n";
+  }
+}
+
+void StyleClasses::write(const std::string &name, HtmlWriter &out) {
+  const auto it = entries_.find(name);
+  if (it == entries_.end()) {
+    unknown_.insert(name);
+    out.attribute(name);
+    return;
+  }
+  it->second.used = true;
+  out.write(values_.data() + it->second.begin, it->second.size);
+}
+
+std::unordered_set<std::string> StyleClasses::used(
+    const std::unordered_map<std::string, std::list<std::string>>
+        &dependencies) const {
+  std::unordered_set<std::string> result = unknown_;
+  std::vector<const std::string *> open;
+  for (auto &&e : entries_) {
+    if (e.second.used && result.insert(e.first).second)
+      open.push_back(&e.first);
+  }
+  while (!open.empty()) {
+    const auto it = dependencies.find(*open.back());
+    open.pop_back();
+    if (it == dependencies.end())
+      continue;
+    for (auto &&d : it->second) {
+      if (result.insert(d).second)
+        open.push_back(&d);
+    }
+  }
+  return result;
+}
+
+} // namespace odr::common
@@ -0,0 +1,159 @@
+#include <access/Path.h>
+#include <access/Storage.h>
+#include <algorithm>
+#include <common/StyleSheet.h>
+#include <crypto/CryptoUtil.h>
+#include <cstring>
+#include <string_view>
+
+namespace odr::common {
+
+namespace {
+bool isClassEnd(const char c) {
+  return std::strchr(" \t\r\n.#:,>+~[](){", c) != nullptr;
+}
+} // namespace
+
+std::vector<StyleSheet::Rule> StyleSheet::rules(const std::string_view css) {
+  std::vector<Rule> result;
+  std::size_t begin = 0;
+  while (begin < css.size()) {
+    const auto open = css.find('{', begin);
+    if (open == std::string_view::npos)
+      break;
+    // quoted values like `content` may contain braces
+    std::size_t end = open + 1;
+    std::uint32_t depth = 1;
+    char quote = '\0';
+    for (; (end < css.size()) && (depth > 0); ++end) {
+      const char c = css[end];
+      if (quote != '\0') {
+        if (c == quote)
+          quote = '\0';
+      } else if ((c == '"') || (c == '\'')) {
+        quote = c;
+      } else if (c == '{') {
+        ++depth;
+      } else if (c == '}') {
+        --depth;
+      }
+    }
+    result.push_back({css.substr(begin, open - begin),
+                      css.substr(open + 1, end - open - 2),
+                      css.substr(begin, end - begin)});
+    begin = end;
+  }
+  return result;
+}
+
+std::vector<std::string_view>
+StyleSheet::classes(const std::string_view selector) {
+  std::vector<std::string_view> result;
+  // preludes like `@media (min-width:1.5em)` name no classes
+  const auto first = selector.find_first_not_of(" \t\r\n");
+  if ((first != std::string_view::npos) && (selector[first] == '@'))
+    return result;
+  // classes in arguments like `:not(.a)` and in attribute selectors are not
+  // needed for a match
+  std::uint32_t depth = 0;
+  for (std::size_t i = 0; i < selector.size(); ++i) {
+    const char c = selector[i];
+    if ((c == '(') || (c == '[')) {
+      ++depth;
+    } else if (((c == ')') || (c == ']')) && (depth > 0)) {
+      --depth;
+    } else if ((c == '.') && (depth == 0)) {
+      auto end = i + 1;
+      while ((end < selector.size()) && !isClassEnd(selector[end]))
+        ++end;
+      result.push_back(selector.substr(i + 1, end - i - 1));
+      i = end - 1;
+    }
+  }
+  return result;
+}
+
+std::string
+StyleSheet::prune(const std::unordered_set<std::string> &used) const {
+  std::string result;
+  for (auto &&rule : rules(css)) {
+    const auto names = classes(rule.selector);
+    if (names.empty() ||
+        std::any_of(names.begin(), names.end(), [&](const auto name) {
+          return used.find(std::string(name)) != used.end();
+        }))
+      result += rule.text;
+  }
+  return result;
+}
+
+StyleSheetCache &StyleSheetCache::instance() {
+  static StyleSheetCache instance(64);
+  return instance;
+}
+
+std::string StyleSheetCache::key(const std::string &kind,
+                                 const access::ReadStorage &storage,
+                                 const access::Path &path) {
+  const auto in = storage.read(path);
+  if (!in)
+    throw access::FileNotFoundException(path.string());
+  return kind + ":" +
+         crypto::Util::hexEncode(crypto::Util::sha256(*in).substr(0, 16));
+}
+
+StyleSheetCache::StyleSheetCache(const std::size_t limit) : limit_{limit} {}
+
+void StyleSheetCache::setLimit(const std::size_t entries) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  limit_ = entries;
+  evict_();
+}
+
+std::size_t StyleSheetCache::limit() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return limit_;
+}
+
+std::size_t StyleSheetCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+std::shared_ptr<const StyleSheet>
+StyleSheetCache::get(const std::string &key, const Compiler &compile) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second.lru);
+      return it->second.styleSheet;
+    }
+  }
+
+  // compile without holding the lock; a concurrent miss compiles twice
+  auto styleSheet = std::make_shared<const StyleSheet>(compile());
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (limit_ == 0 || entries_.find(key) != entries_.end())
+    return styleSheet;
+  lru_.push_front(key);
+  entries_[key] = {styleSheet, lru_.begin()};
+  evict_();
+  return styleSheet;
+}
+
+void StyleSheetCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lru_.clear();
+}
+
+void StyleSheetCache::evict_() {
+  while (entries_.size() > limit_) {
+    entries_.erase(lru_.back());
+    lru_.pop_back();
+  }
+}
+
+} // namespace odr::common
@@ -0,0 +1,29 @@
+#include <algorithm>
+#include <common/TableRowIndex.h>
+
+namespace odr::common {
+
+TableRowIndex::TableRowIndex(const std::uint32_t stride) noexcept
+    : stride_{std::max<std::uint32_t>(stride, 1)} {}
+
+void TableRowIndex::add(const std::uint32_t row, const std::uint64_t offset) {
+  if (marks_.empty() ||
+      (row >= marks_.back().row && row - marks_.back().row >= stride_))
+    marks_.push_back({row, offset});
+}
+
+std::uint64_t TableRowIndex::begin() const noexcept {
+  return marks_.front().offset;
+}
+
+const TableRowIndex::Mark &
+TableRowIndex::find(const std::uint32_t row) const noexcept {
+  const auto it = std::upper_bound(
+      marks_.begin(), marks_.end(), row,
+      [](const std::uint32_t r, const Mark &mark) { return r < mark.row; });
+  if (it == marks_.begin())
+    return marks_.front();
+  return *std::prev(it);
+}
+
+} // namespace odr::common
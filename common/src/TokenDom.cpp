@@ -0,0 +1,435 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <common/TokenDom.h>
+#include <common/XmlUtil.h>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace odr::common {
+
+namespace {
+// character classes looked up by byte like pugixml does
+constexpr std::uint8_t whitespace = 1;
+constexpr std::uint8_t nameEnd = 2;
+
+constexpr std::array<std::uint8_t, 256> characterClasses() {
+  std::array<std::uint8_t, 256> result{};
+  for (const unsigned char c : {' ', '\t', '\r', '\n'})
+    result[c] = whitespace | nameEnd;
+  for (const unsigned char c : {'/', '>', '='})
+    result[c] = nameEnd;
+  return result;
+}
+
+constexpr auto classes = characterClasses();
+
+bool isWhitespace(const char c) {
+  return classes[static_cast<unsigned char>(c)] & whitespace;
+}
+
+bool isNameEnd(const char c) {
+  return classes[static_cast<unsigned char>(c)] & nameEnd;
+}
+
+char *writeUtf8(char *out, const std::uint32_t code) {
+  if (code < 0x80) {
+    *out++ = static_cast<char>(code);
+  } else if (code < 0x800) {
+    *out++ = static_cast<char>(0xc0 | (code >> 6));
+    *out++ = static_cast<char>(0x80 | (code & 0x3f));
+  } else if (code < 0x10000) {
+    *out++ = static_cast<char>(0xe0 | (code >> 12));
+    *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+    *out++ = static_cast<char>(0x80 | (code & 0x3f));
+  } else {
+    *out++ = static_cast<char>(0xf0 | (code >> 18));
+    *out++ = static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+    *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+    *out++ = static_cast<char>(0x80 | (code & 0x3f));
+  }
+  return out;
+}
+
+// decodes the entity at `it` to `out` and returns the position after it. an
+// unknown entity is kept verbatim like pugixml does; a character reference
+// beyond unicode becomes U+FFFD. the result is never longer than the entity,
+// so `out` may trail `it` in the same buffer.
+const char *decodeEntity(const char *it, const char *end, char *&out) {
+  const char *semicolon = static_cast<const char *>(
+      std::memchr(it, ';', std::min<std::size_t>(end - it, 12)));
+  if (semicolon == nullptr) {
+    *out++ = *it;
+    return it + 1;
+  }
+  const std::string_view entity(it + 1, semicolon - it - 1);
+  char replacement = '\0';
+  if (entity == "lt")
+    replacement = '<';
+  else if (entity == "gt")
+    replacement = '>';
+  else if (entity == "amp")
+    replacement = '&';
+  else if (entity == "apos")
+    replacement = '\'';
+  else if (entity == "quot")
+    replacement = '"';
+  if (replacement != '\0') {
+    *out++ = replacement;
+    return semicolon + 1;
+  }
+
+  if ((entity.size() > 1) && (entity[0] == '#')) {
+    const bool hex = (entity[1] == 'x');
+    const char *digits = entity.data() + (hex ? 2 : 1);
+    std::uint32_t code = 0;
+    const auto result = std::from_chars(digits, semicolon, code, hex ? 16 : 10);
+    if ((digits != semicolon) && (result.ec == std::errc()) &&
+        (result.ptr == semicolon)) {
+      out = writeUtf8(out, code > 0x10ffff ? 0xfffd : code);
+      return semicolon + 1;
+    }
+  }
+  *out++ = *it;
+  return it + 1;
+}
+
+// decodes `[begin, end)` in place and returns the new end
+char *decode(char *begin, char *end, const bool attribute) {
+  // most text needs no decoding and is only scanned
+  char *first = begin;
+  while ((first != end) && (*first != '&') && (*first != '\r') &&
+         !(attribute && ((*first == '\n') || (*first == '\t'))))
+    ++first;
+  char *out = first;
+  for (const char *it = first; it != end;) {
+    if (*it == '&') {
+      it = decodeEntity(it, end, out);
+    } else if (*it == '\r') {
+      *out++ = attribute ? ' ' : '\n';
+      ++it;
+      if ((it != end) && (*it == '\n'))
+        ++it;
+    } else if (attribute && ((*it == '\n') || (*it == '\t'))) {
+      *out++ = ' ';
+      ++it;
+    } else {
+      *out++ = *it++;
+    }
+  }
+  return out;
+}
+
+char *find(char *begin, char *end, const char *pattern) {
+  const std::size_t length = std::strlen(pattern);
+  for (char *it = begin; it + length <= end; ++it) {
+    it = static_cast<char *>(std::memchr(it, pattern[0], end - it));
+    if (it == nullptr)
+      break;
+    if ((it + length <= end) && (std::memcmp(it, pattern, length) == 0))
+      return it;
+  }
+  throw NotXmlException();
+}
+} // namespace
+
+TokenDom::Token TokenDom::Attribute::token() const noexcept {
+  return dom_->attributes_[index_].name;
+}
+
+std::string_view TokenDom::Attribute::name() const noexcept {
+  return dom_->names_[token()];
+}
+
+std::string_view TokenDom::Attribute::as_string() const noexcept {
+  if (dom_ == nullptr)
+    return {};
+  const AttributeData &data = dom_->attributes_[index_];
+  return {dom_->buffer_.data() + data.begin, data.size};
+}
+
+std::uint32_t TokenDom::Attribute::as_uint(const std::uint32_t def) const
+    noexcept {
+  if (dom_ == nullptr)
+    return def;
+  const std::string_view value = as_string();
+  std::uint32_t result = 0;
+  std::from_chars(value.data(), value.data() + value.size(), result);
+  return result;
+}
+
+TokenDom::Node::Iterator &TokenDom::Node::Iterator::operator++() noexcept {
+  index_ = dom_->nodes_[index_].nextSibling;
+  return *this;
+}
+
+bool TokenDom::Node::isElement() const noexcept {
+  return (dom_ != nullptr) && (dom_->nodes_[index_].kind == Kind::ELEMENT);
+}
+
+bool TokenDom::Node::isText() const noexcept {
+  return (dom_ != nullptr) && (dom_->nodes_[index_].kind == Kind::TEXT);
+}
+
+bool TokenDom::Node::isCdata() const noexcept {
+  return (dom_ != nullptr) && (dom_->nodes_[index_].kind == Kind::CDATA);
+}
+
+TokenDom::Token TokenDom::Node::token() const noexcept {
+  return dom_->nodes_[index_].name;
+}
+
+std::string_view TokenDom::Node::name() const noexcept {
+  return dom_->names_[token()];
+}
+
+std::string_view TokenDom::Node::text() const noexcept {
+  const NodeData &data = dom_->nodes_[index_];
+  if ((data.kind != Kind::TEXT) && (data.kind != Kind::CDATA))
+    return {};
+  return {dom_->buffer_.data() + data.begin, data.size};
+}
+
+TokenDom::Attribute
+TokenDom::Node::attribute(const std::string_view name) const noexcept {
+  for (auto &&a : attributes()) {
+    if (a.name() == name)
+      return a;
+  }
+  return {};
+}
+
+TokenDom::Attribute TokenDom::Node::attribute(const Token token) const
+    noexcept {
+  for (auto &&a : attributes()) {
+    if (a.token() == token)
+      return a;
+  }
+  return {};
+}
+
+TokenDom::Node::AttributeRange TokenDom::Node::attributes() const noexcept {
+  AttributeRange result;
+  result.dom_ = dom_;
+  result.begin_ = 0;
+  result.end_ = 0;
+  if (isElement()) {
+    const NodeData &data = dom_->nodes_[index_];
+    result.begin_ = data.begin;
+    result.end_ = data.begin + data.size;
+  }
+  return result;
+}
+
+TokenDom::Node TokenDom::Node::first_child() const noexcept {
+  if (dom_ == nullptr)
+    return {};
+  const std::uint32_t child = dom_->nodes_[index_].firstChild;
+  return child == none_ ? Node() : Node(dom_, child);
+}
+
+TokenDom::Node TokenDom::Node::next_sibling() const noexcept {
+  if (dom_ == nullptr)
+    return {};
+  const std::uint32_t sibling = dom_->nodes_[index_].nextSibling;
+  return sibling == none_ ? Node() : Node(dom_, sibling);
+}
+
+TokenDom::Node::Iterator TokenDom::Node::begin() const noexcept {
+  return {dom_, dom_ == nullptr ? none_ : dom_->nodes_[index_].firstChild};
+}
+
+TokenDom::Node TokenDom::Node::child(const std::string_view name) const
+    noexcept {
+  for (auto &&n : *this) {
+    if (n.isElement() && (n.name() == name))
+      return n;
+  }
+  return {};
+}
+
+TokenDom::TokenDom(std::string xml) : buffer_{std::move(xml)} {
+  // offsets are 32 bit
+  if (buffer_.size() > std::numeric_limits<std::uint32_t>::max())
+    throw std::length_error("xml exceeds 4 GiB");
+  // empty name for text nodes and the document
+  names_.emplace_back();
+  parse_();
+}
+
+TokenDom::Token TokenDom::token(const std::string_view name) const noexcept {
+  const auto it = tokens_.find(name);
+  return it == tokens_.end() ? noToken : it->second;
+}
+
+std::size_t TokenDom::memory() const noexcept {
+  return buffer_.capacity() + nodes_.capacity() * sizeof(NodeData) +
+         attributes_.capacity() * sizeof(AttributeData) +
+         names_.capacity() * sizeof(std::string_view) +
+         tokens_.size() * (sizeof(std::string_view) + sizeof(Token) +
+                           2 * sizeof(void *));
+}
+
+TokenDom::Token TokenDom::intern_(const std::string_view name) {
+  const auto it = tokens_.find(name);
+  if (it != tokens_.end())
+    return it->second;
+  const auto token = static_cast<Token>(names_.size());
+  names_.push_back(name);
+  tokens_.emplace(name, token);
+  return token;
+}
+
+void TokenDom::parse_() {
+  struct Open {
+    std::uint32_t node;
+    std::uint32_t lastChild;
+  };
+
+  char *const base = buffer_.data();
+  char *const end = base + buffer_.size();
+  // an element has one or two tags and text lies between tags, so there are
+  // about as many nodes as `<`; counting first avoids growing the array
+  nodes_.reserve(std::count(base, end, '<') + 1);
+  nodes_.push_back({Kind::DOCUMENT, noToken, none_, none_, 0, 0});
+  std::vector<Open> stack{{0, none_}};
+
+  const auto append = [&](const NodeData &node) {
+    const auto index = static_cast<std::uint32_t>(nodes_.size());
+    nodes_.push_back(node);
+    Open &parent = stack.back();
+    if (parent.lastChild == none_)
+      nodes_[parent.node].firstChild = index;
+    else
+      nodes_[parent.lastChild].nextSibling = index;
+    parent.lastChild = index;
+    return index;
+  };
+  const auto appendText = [&](char *begin, char *textEnd, const Kind kind) {
+    if (stack.size() == 1)
+      return;
+    append({kind, noToken, none_, none_,
+            static_cast<std::uint32_t>(begin - base),
+            static_cast<std::uint32_t>(textEnd - begin)});
+  };
+
+  char *it = base;
+  while (it != end) {
+    if (*it != '<') {
+      char *textEnd = static_cast<char *>(std::memchr(it, '<', end - it));
+      if (textEnd == nullptr)
+        textEnd = end;
+      if (!std::all_of(it, textEnd, isWhitespace))
+        appendText(it, decode(it, textEnd, false), Kind::TEXT);
+      it = textEnd;
+      continue;
+    }
+
+    if (end - it < 2)
+      throw NotXmlException();
+    if (it[1] == '?') {
+      it = find(it + 2, end, "?>") + 2;
+    } else if (it[1] == '!') {
+      if ((end - it >= 4) && (std::memcmp(it, "<!--", 4) == 0)) {
+        it = find(it + 4, end, "-->") + 3;
+      } else if ((end - it >= 9) && (std::memcmp(it, "<![CDATA[", 9) == 0)) {
+        char *cdataEnd = find(it + 9, end, "]]>");
+        // cdata keeps its content apart from line endings
+        char *out = it + 9;
+        for (const char *c = it + 9; c != cdataEnd; ++c) {
+          if ((*c == '\r') && (c + 1 != cdataEnd) && (c[1] == '\n'))
+            continue;
+          *out++ = (*c == '\r') ? '\n' : *c;
+        }
+        appendText(it + 9, out, Kind::CDATA);
+        it = cdataEnd + 3;
+      } else {
+        // doctype, possibly with an internal subset
+        char *bracket = static_cast<char *>(std::memchr(it, '[', end - it));
+        char *close = find(it, end, ">");
+        if ((bracket != nullptr) && (bracket < close))
+          close = find(find(bracket, end, "]"), end, ">");
+        it = close + 1;
+      }
+    } else if (it[1] == '/') {
+      char *nameBegin = it + 2;
+      char *close = find(nameBegin, end, ">");
+      char *nameEnd = nameBegin;
+      while ((nameEnd != close) && !isWhitespace(*nameEnd))
+        ++nameEnd;
+      if ((stack.size() == 1) ||
+          (names_[nodes_[stack.back().node].name] !=
+           std::string_view(nameBegin, nameEnd - nameBegin)))
+        throw NotXmlException();
+      stack.pop_back();
+      it = close + 1;
+    } else {
+      char *nameBegin = it + 1;
+      char *c = nameBegin;
+      while ((c != end) && !isNameEnd(*c))
+        ++c;
+      if ((c == end) || (c == nameBegin))
+        throw NotXmlException();
+      const Token name = intern_(std::string_view(nameBegin, c - nameBegin));
+      const auto attributeBegin =
+          static_cast<std::uint32_t>(attributes_.size());
+
+      bool selfClosing = false;
+      while (true) {
+        while ((c != end) && isWhitespace(*c))
+          ++c;
+        if (c == end)
+          throw NotXmlException();
+        if (*c == '>') {
+          ++c;
+          break;
+        }
+        if (*c == '/') {
+          if ((c + 1 == end) || (c[1] != '>'))
+            throw NotXmlException();
+          selfClosing = true;
+          c += 2;
+          break;
+        }
+        char *attributeName = c;
+        while ((c != end) && !isNameEnd(*c))
+          ++c;
+        const std::string_view attribute(attributeName, c - attributeName);
+        while ((c != end) && isWhitespace(*c))
+          ++c;
+        if ((c == end) || (*c != '=') || attribute.empty())
+          throw NotXmlException();
+        ++c;
+        while ((c != end) && isWhitespace(*c))
+          ++c;
+        if ((c == end) || ((*c != '"') && (*c != '\'')))
+          throw NotXmlException();
+        char *value = c + 1;
+        char *valueEnd =
+            static_cast<char *>(std::memchr(value, *c, end - value));
+        if (valueEnd == nullptr)
+          throw NotXmlException();
+        char *decodedEnd = decode(value, valueEnd, true);
+        attributes_.push_back({intern_(attribute),
+                               static_cast<std::uint32_t>(value - base),
+                               static_cast<std::uint32_t>(decodedEnd - value)});
+        c = valueEnd + 1;
+      }
+
+      const std::uint32_t node =
+          append({Kind::ELEMENT, name, none_, none_, attributeBegin,
+                  static_cast<std::uint32_t>(attributes_.size()) -
+                      attributeBegin});
+      if (!selfClosing)
+        stack.push_back({node, none_});
+      it = c;
+    }
+  }
+
+  // like pugixml a document needs an element
+  if ((stack.size() != 1) || (nodes_[0].firstChild == none_))
+    throw NotXmlException();
+}
+
+} // namespace odr::common
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <common/XmlArena.h>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <pugixml.hpp>
+
+namespace odr::common {
+
+namespace {
+// precedes every pugixml allocation; tells the free hook where the memory
+// came from. the tag sits right in front of the block and tells it apart from
+// blocks allocated before the hooks were installed.
+struct alignas(alignof(std::max_align_t)) Header {
+  XmlArena *arena;
+  std::uint64_t tag;
+};
+
+constexpr std::uint64_t headerTag = 0x6f64724172656e61;
+
+thread_local XmlArena *current_ = nullptr;
+// what pugixml used before the hooks; frees the foreign blocks
+pugi::deallocation_function previousDeallocate_ = nullptr;
+
+std::size_t align(const std::size_t size) {
+  constexpr std::size_t alignment = alignof(std::max_align_t);
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+void *allocateHook(const std::size_t size) {
+  Header *header;
+  if (current_ != nullptr) {
+    try {
+      header = static_cast<Header *>(current_->allocate(sizeof(Header) + size));
+    } catch (...) {
+      // pugixml reports out of memory itself
+      return nullptr;
+    }
+  } else {
+    header = static_cast<Header *>(std::malloc(sizeof(Header) + size));
+    if (header == nullptr)
+      return nullptr;
+  }
+  header->arena = current_;
+  header->tag = headerTag;
+  return header + 1;
+}
+
+void deallocateHook(void *ptr) {
+  if (ptr == nullptr)
+    return;
+  Header *header = static_cast<Header *>(ptr) - 1;
+  if (header->tag != headerTag)
+    previousDeallocate_(ptr);
+  else if (header->arena != nullptr)
+    header->arena->deallocate(header);
+  else
+    std::free(header);
+}
+} // namespace
+
+void XmlArena::installHooks() {
+  static std::once_flag installed;
+  std::call_once(installed, [] {
+    previousDeallocate_ = pugi::get_memory_deallocation_function();
+    pugi::set_memory_management_functions(allocateHook, deallocateHook);
+  });
+}
+
+XmlArena *XmlArena::current() noexcept { return current_; }
+
+XmlArena::Scope::Scope(XmlArena &arena) noexcept : previous_{current_} {
+  current_ = &arena;
+}
+
+XmlArena::Scope::~Scope() { current_ = previous_; }
+
+XmlArena::XmlArena(const std::size_t blockSize) : blockSize_{blockSize} {
+  installHooks();
+}
+
+XmlArena::~XmlArena() {
+  // memory of documents outliving the arena is leaked rather than freed
+  // under their feet
+  if (live_ != 0)
+    return;
+  for (auto &&block : blocks_) {
+    std::free(block.data);
+  }
+}
+
+void *XmlArena::allocate(std::size_t size) {
+  size = align(size);
+
+  while (block_ < blocks_.size()) {
+    if (blocks_[block_].size - offset_ >= size)
+      break;
+    ++block_;
+    offset_ = 0;
+  }
+  if (block_ == blocks_.size()) {
+    const std::size_t blockSize = std::max(blockSize_, size);
+    auto data = static_cast<char *>(std::malloc(blockSize));
+    if (data == nullptr)
+      throw std::bad_alloc();
+    blocks_.push_back({data, blockSize});
+    stats_.reserved += blockSize;
+  } else if (block_ < retained_) {
+    stats_.reused += size;
+  }
+
+  void *result = blocks_[block_].data + offset_;
+  offset_ += size;
+  stats_.used += size;
+  stats_.peak = std::max(stats_.peak, stats_.used);
+  ++live_;
+  return result;
+}
+
+void XmlArena::deallocate(void *) noexcept { --live_; }
+
+void XmlArena::reset() {
+  if (live_ != 0)
+    throw XmlArenaInUseException();
+  block_ = 0;
+  offset_ = 0;
+  retained_ = blocks_.size();
+  stats_.used = 0;
+}
+
+} // namespace odr::common
@@ -0,0 +1,64 @@
+#include <access/Path.h>
+#include <access/Storage.h>
+#include <common/XmlCache.h>
+#include <common/XmlUtil.h>
+#include <pugixml.hpp>
+
+namespace odr::common {
+
+namespace {
+// rough ratio of pugixml memory to source size
+constexpr std::uint64_t domOverhead = 3;
+} // namespace
+
+XmlCache::XmlCache(const access::ReadStorage *storage) noexcept
+    : storage_{storage} {}
+
+void XmlCache::setStorage(const access::ReadStorage *storage) noexcept {
+  // a replaced storage may live at the address of the old one, so the pointer
+  // says nothing about the parts
+  clear();
+  storage_ = storage;
+}
+
+void XmlCache::setLimit(const std::uint64_t bytes) noexcept {
+  limit_ = bytes;
+  evict_();
+}
+
+std::shared_ptr<pugi::xml_document> XmlCache::get(const access::Path &path) {
+  const auto it = entries_.find(path.string());
+  if (it != entries_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+    return it->second.document;
+  }
+
+  auto document =
+      std::make_shared<pugi::xml_document>(XmlUtil::parse(*storage_, path));
+  if (limit_ == 0)
+    return document;
+
+  const std::uint64_t size = domOverhead * storage_->size(path);
+  lru_.push_front(path.string());
+  entries_[path.string()] = {document, size, lru_.begin()};
+  size_ += size;
+  evict_();
+  return document;
+}
+
+void XmlCache::clear() noexcept {
+  entries_.clear();
+  lru_.clear();
+  size_ = 0;
+}
+
+void XmlCache::evict_() noexcept {
+  while ((size_ > limit_) && !lru_.empty()) {
+    const auto it = entries_.find(lru_.back());
+    size_ -= it->second.size;
+    entries_.erase(it);
+    lru_.pop_back();
+  }
+}
+
+} // namespace odr::common
@@ -0,0 +1,354 @@
+#include <algorithm>
+#include <common/XmlPullParser.h>
+#include <common/XmlUtil.h>
+#include <cstring>
+#include <istream>
+#include <pugixml.hpp>
+
+namespace odr::common {
+
+namespace {
+bool isWhitespace(const char c) {
+  return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+}
+
+void appendUtf8(std::string &out, const std::uint32_t code) {
+  if (code < 0x80) {
+    out += static_cast<char>(code);
+  } else if (code < 0x800) {
+    out += static_cast<char>(0xc0 | (code >> 6));
+    out += static_cast<char>(0x80 | (code & 0x3f));
+  } else if (code < 0x10000) {
+    out += static_cast<char>(0xe0 | (code >> 12));
+    out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (code & 0x3f));
+  } else {
+    out += static_cast<char>(0xf0 | (code >> 18));
+    out += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+    out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (code & 0x3f));
+  }
+}
+
+// returns the length of the entity at `begin` or zero if it is unknown, in
+// which case it is kept verbatim like pugixml does
+std::size_t decodeEntity(const char *begin, const char *end,
+                         std::string &out) {
+  const char *semicolon = static_cast<const char *>(
+      std::memchr(begin, ';', std::min<std::size_t>(end - begin, 12)));
+  if (semicolon == nullptr)
+    return 0;
+  const std::string entity(begin + 1, semicolon);
+  if (entity == "lt")
+    out += '<';
+  else if (entity == "gt")
+    out += '>';
+  else if (entity == "amp")
+    out += '&';
+  else if (entity == "apos")
+    out += '\'';
+  else if (entity == "quot")
+    out += '"';
+  else if ((entity.size() > 1) && (entity[0] == '#')) {
+    const bool hex = (entity[1] == 'x');
+    const std::string digits = entity.substr(hex ? 2 : 1);
+    if (digits.empty() ||
+        (digits.find_first_not_of(hex ? "0123456789abcdefABCDEF"
+                                      : "0123456789") != std::string::npos))
+      return 0;
+    appendUtf8(out, std::stoul(digits, nullptr, hex ? 16 : 10));
+  } else {
+    return 0;
+  }
+  return semicolon - begin + 1;
+}
+
+void decode(const char *begin, const char *end, const bool attribute,
+            std::string &out) {
+  out.clear();
+  out.reserve(end - begin);
+  for (const char *it = begin; it != end; ++it) {
+    if (*it == '&') {
+      const std::size_t length = decodeEntity(it, end, out);
+      if (length > 0) {
+        it += length - 1;
+        continue;
+      }
+      out += '&';
+    } else if (*it == '\r') {
+      out += attribute ? ' ' : '\n';
+      if ((it + 1 != end) && (*(it + 1) == '\n'))
+        ++it;
+    } else if (attribute && ((*it == '\n') || (*it == '\t'))) {
+      out += ' ';
+    } else {
+      out += *it;
+    }
+  }
+}
+
+void normalizeEol(const char *begin, const char *end, std::string &out) {
+  out.clear();
+  out.reserve(end - begin);
+  for (const char *it = begin; it != end; ++it) {
+    if (*it == '\r') {
+      out += '\n';
+      if ((it + 1 != end) && (*(it + 1) == '\n'))
+        ++it;
+    } else {
+      out += *it;
+    }
+  }
+}
+} // namespace
+
+XmlPullParser::XmlPullParser(std::istream &in, const std::size_t chunkSize)
+    : in_{in}, chunkSize_{chunkSize} {}
+
+XmlPullParser::Event XmlPullParser::next() {
+  if (selfClosing_) {
+    selfClosing_ = false;
+    stack_.pop_back();
+    return event_ = Event::END_ELEMENT;
+  }
+
+  while (true) {
+    if ((pos_ >= buffer_.size()) && !fill_()) {
+      if (!stack_.empty())
+        throw NotXmlException();
+      return event_ = Event::END_DOCUMENT;
+    }
+    offset_ = base_ + pos_;
+
+    if (buffer_[pos_] != '<') {
+      const std::size_t end = find_("<");
+      const std::size_t length =
+          (end == std::string::npos) ? buffer_.size() - pos_ : end;
+      const char *begin = buffer_.data() + pos_;
+      pos_ += length;
+      if (stack_.empty() || std::all_of(begin, begin + length, isWhitespace))
+        continue;
+      decode(begin, begin + length, false, text_);
+      return event_ = Event::TEXT;
+    }
+
+    while ((buffer_.size() - pos_ < 9) && fill_()) {
+    }
+
+    if (buffer_.compare(pos_, 2, "<?") == 0) {
+      const std::size_t end = find_("?>");
+      if (end == std::string::npos)
+        throw NotXmlException();
+      pos_ += end + 2;
+    } else if (buffer_.compare(pos_, 4, "<!--") == 0) {
+      const std::size_t end = find_("-->");
+      if (end == std::string::npos)
+        throw NotXmlException();
+      pos_ += end + 3;
+    } else if (buffer_.compare(pos_, 9, "<![CDATA[") == 0) {
+      const std::size_t end = find_("]]>");
+      if (end == std::string::npos)
+        throw NotXmlException();
+      const char *begin = buffer_.data() + pos_;
+      pos_ += end + 3;
+      if (stack_.empty())
+        continue;
+      normalizeEol(begin + 9, begin + end, text_);
+      return event_ = Event::CDATA;
+    } else if (buffer_.compare(pos_, 2, "<!") == 0) {
+      // doctype; an internal subset ends with `]>`
+      std::size_t end = findTagEnd_();
+      if (end == std::string::npos)
+        throw NotXmlException();
+      const std::size_t subset = buffer_.find('[', pos_);
+      if ((subset != std::string::npos) && (subset - pos_ < end)) {
+        end = find_("]>");
+        if (end == std::string::npos)
+          throw NotXmlException();
+        ++end;
+      }
+      pos_ += end + 1;
+    } else if (buffer_.compare(pos_, 2, "</") == 0) {
+      const std::size_t end = findTagEnd_();
+      if (end == std::string::npos)
+        throw NotXmlException();
+      parseEndTag_(end);
+      pos_ += end + 1;
+      return event_ = Event::END_ELEMENT;
+    } else {
+      const std::size_t end = findTagEnd_();
+      if (end == std::string::npos)
+        throw NotXmlException();
+      parseStartTag_(end);
+      pos_ += end + 1;
+      return event_ = Event::START_ELEMENT;
+    }
+  }
+}
+
+const char *XmlPullParser::attribute(const std::string &name) const noexcept {
+  for (auto &&a : attributes_) {
+    if (a.name == name)
+      return a.value.c_str();
+  }
+  return nullptr;
+}
+
+void XmlPullParser::skip() {
+  const std::uint32_t depth = stack_.size();
+  while (true) {
+    const Event event = next();
+    if ((event == Event::END_ELEMENT) && (stack_.size() < depth))
+      return;
+    if (event == Event::END_DOCUMENT)
+      throw NotXmlException();
+  }
+}
+
+pugi::xml_node XmlPullParser::append(pugi::xml_node parent) const {
+  pugi::xml_node result = parent.append_child(name_.c_str());
+  for (auto &&a : attributes_) {
+    result.append_attribute(a.name.c_str()).set_value(a.value.c_str());
+  }
+  return result;
+}
+
+pugi::xml_node XmlPullParser::copy(pugi::xml_node parent) {
+  const std::uint32_t depth = stack_.size();
+  const pugi::xml_node result = append(parent);
+  pugi::xml_node node = result;
+  while (true) {
+    switch (next()) {
+    case Event::START_ELEMENT:
+      node = append(node);
+      break;
+    case Event::END_ELEMENT:
+      if (stack_.size() < depth)
+        return result;
+      node = node.parent();
+      break;
+    case Event::TEXT:
+      node.append_child(pugi::node_pcdata).set_value(text_.c_str());
+      break;
+    case Event::CDATA:
+      node.append_child(pugi::node_cdata).set_value(text_.c_str());
+      break;
+    case Event::END_DOCUMENT:
+      throw NotXmlException();
+    }
+  }
+}
+
+bool XmlPullParser::fill_() {
+  if (eof_)
+    return false;
+  // keep the unconsumed rest; offsets relative to `pos_` stay valid
+  if (pos_ > 0) {
+    buffer_.erase(0, pos_);
+    base_ += pos_;
+    pos_ = 0;
+  }
+  const std::size_t size = buffer_.size();
+  buffer_.resize(size + chunkSize_);
+  in_.read(buffer_.data() + size, chunkSize_);
+  const std::size_t read = in_.gcount();
+  buffer_.resize(size + read);
+  if (read < chunkSize_)
+    eof_ = true;
+  return read > 0;
+}
+
+std::size_t XmlPullParser::find_(const char *pattern) {
+  const std::size_t length = std::strlen(pattern);
+  std::size_t from = 0;
+  while (true) {
+    const std::size_t result = buffer_.find(pattern, pos_ + from);
+    if (result != std::string::npos)
+      return result - pos_;
+    const std::size_t searched = buffer_.size() - pos_;
+    from = (searched >= length) ? searched - length + 1 : 0;
+    if (!fill_())
+      return std::string::npos;
+  }
+}
+
+std::size_t XmlPullParser::findTagEnd_() {
+  char quote = '\0';
+  std::size_t i = 1;
+  while (true) {
+    if ((pos_ + i >= buffer_.size()) && !fill_())
+      return std::string::npos;
+    const char c = buffer_[pos_ + i];
+    if (quote != '\0') {
+      if (c == quote)
+        quote = '\0';
+    } else if ((c == '"') || (c == '\'')) {
+      quote = c;
+    } else if (c == '>') {
+      return i;
+    }
+    ++i;
+  }
+}
+
+void XmlPullParser::parseStartTag_(const std::size_t end) {
+  const char *it = buffer_.data() + pos_ + 1;
+  const char *limit = buffer_.data() + pos_ + end;
+  selfClosing_ = *(limit - 1) == '/';
+  if (selfClosing_)
+    --limit;
+
+  const char *nameEnd = it;
+  while ((nameEnd != limit) && !isWhitespace(*nameEnd))
+    ++nameEnd;
+  if (nameEnd == it)
+    throw NotXmlException();
+  name_.assign(it, nameEnd);
+  it = nameEnd;
+
+  attributes_.clear();
+  while (true) {
+    while ((it != limit) && isWhitespace(*it))
+      ++it;
+    if (it == limit)
+      break;
+    const char *attributeEnd = it;
+    while ((attributeEnd != limit) && (*attributeEnd != '=') &&
+           !isWhitespace(*attributeEnd))
+      ++attributeEnd;
+    Attribute attribute;
+    attribute.name.assign(it, attributeEnd);
+    it = attributeEnd;
+    while ((it != limit) && isWhitespace(*it))
+      ++it;
+    if ((it == limit) || (*it != '='))
+      throw NotXmlException();
+    ++it;
+    while ((it != limit) && isWhitespace(*it))
+      ++it;
+    if ((it == limit) || ((*it != '"') && (*it != '\'')))
+      throw NotXmlException();
+    const char *valueEnd = static_cast<const char *>(
+        std::memchr(it + 1, *it, limit - it - 1));
+    if (valueEnd == nullptr)
+      throw NotXmlException();
+    decode(it + 1, valueEnd, true, attribute.value);
+    attributes_.push_back(std::move(attribute));
+    it = valueEnd + 1;
+  }
+
+  stack_.push_back(name_);
+}
+
+void XmlPullParser::parseEndTag_(const std::size_t end) {
+  const char *it = buffer_.data() + pos_ + 2;
+  const char *limit = buffer_.data() + pos_ + end;
+  while ((limit != it) && isWhitespace(*(limit - 1)))
+    --limit;
+  name_.assign(it, limit);
+  if (stack_.empty() || (stack_.back() != name_))
+    throw NotXmlException();
+  stack_.pop_back();
+}
+
+} // namespace odr::common
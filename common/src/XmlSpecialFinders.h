@@ -0,0 +1,22 @@
+#ifndef ODR_COMMON_XML_SPECIAL_FINDERS_H
+#define ODR_COMMON_XML_SPECIAL_FINDERS_H
+
+#include <cstddef>
+
+namespace odr::common::StringUtil {
+// like `findXmlSpecial` on `size` bytes of `data`
+using XmlSpecialFinder = std::size_t (*)(const char *data, std::size_t pos,
+                                         std::size_t size, bool attribute);
+
+// the variants behind `findXmlSpecial`, exposed for tests and benchmarks. the
+// vectorized ones are null where the compiler or the cpu lacks them
+struct XmlSpecialFinders final {
+  XmlSpecialFinder scalar;
+  XmlSpecialFinder sse2;
+  XmlSpecialFinder avx2;
+};
+
+const XmlSpecialFinders &xmlSpecialFinders();
+} // namespace odr::common::StringUtil
+
+#endif // ODR_COMMON_XML_SPECIAL_FINDERS_H
@@ -1,22 +1,54 @@
 #include <access/Path.h>
 #include <access/Storage.h>
 #include <access/StreamUtil.h>
+#include <algorithm>
+#include <common/XmlArena.h>
 #include <common/XmlUtil.h>
+#include <cstring>
+#include <memory>
 #include <pugixml.hpp>
 
 namespace odr::common {
 
+namespace {
+// no processing instructions, comments or doctype. whitespace-only text nodes
+// are dropped as before; the translators rely on escapes, CDATA and
+// normalized line endings.
+constexpr unsigned int parseFlags = pugi::parse_cdata | pugi::parse_escapes |
+                                    pugi::parse_wconv_attribute |
+                                    pugi::parse_eol;
+// used if the storage does not know the size upfront
+constexpr std::uint64_t fallbackSize = 4096;
+
+struct PugiDeleter {
+  void operator()(char *buffer) const {
+    pugi::get_memory_deallocation_function()(buffer);
+  }
+};
+using PugiBuffer = std::unique_ptr<char, PugiDeleter>;
+
+PugiBuffer allocate(const std::uint64_t size) {
+  auto result = static_cast<char *>(
+      pugi::get_memory_allocation_function()(std::max<std::uint64_t>(size, 1)));
+  if (result == nullptr)
+    throw std::bad_alloc();
+  return PugiBuffer(result);
+}
+} // namespace
+
 pugi::xml_document XmlUtil::parse(const std::string &in) {
+  XmlArena::installHooks();
   pugi::xml_document result;
-  const auto success = result.load_string(in.c_str());
+  const auto success = result.load_string(in.c_str(), parseFlags);
   if (!success)
     throw NotXmlException();
   return result;
 }
 
 pugi::xml_document XmlUtil::parse(std::istream &in) {
+  XmlArena::installHooks();
   pugi::xml_document result;
-  const auto success = result.load(in);
+  const auto success = result.load(in, parseFlags);
   if (!success)
     throw NotXmlException();
   return result;
@@ -24,11 +56,34 @@ pugi::xml_document XmlUtil::parse(std::istream &in) {
 
 pugi::xml_document XmlUtil::parse(const access::ReadStorage &storage,
                                   const access::Path &path) {
-  pugi::xml_document result;
+  XmlArena::installHooks();
   auto in = storage.read(path);
   if (!in)
     throw access::FileNotFoundException(path.string());
-  const auto success = result.load(*in);
+
+  // inflate straight into one buffer of the uncompressed size and let pugixml
+  // parse it in place instead of copying the stream chunk by chunk
+  std::uint64_t capacity = storage.size(path);
+  if (capacity == 0)
+    capacity = fallbackSize;
+  PugiBuffer buffer = allocate(capacity);
+  std::uint64_t size = 0;
+  while (true) {
+    in->read(buffer.get() + size, capacity - size);
+    size += in->gcount();
+    if ((size < capacity) || (in->peek() == std::char_traits<char>::eof()))
+      break;
+    // the announced size was wrong
+    PugiBuffer grown = allocate(2 * capacity);
+    std::memcpy(grown.get(), buffer.get(), size);
+    buffer = std::move(grown);
+    capacity *= 2;
+  }
+
+  pugi::xml_document result;
+  // the document takes ownership of the buffer even if parsing fails
+  const auto success =
+      result.load_buffer_inplace_own(buffer.release(), size, parseFlags);
   if (!success)
     throw NotXmlException();
   return result;
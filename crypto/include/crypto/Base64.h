@@ -0,0 +1,25 @@
+#ifndef ODR_CRYPTO_BASE64_H
+#define ODR_CRYPTO_BASE64_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace odr::crypto::Base64 {
+// size of the padded encoding of `size` bytes
+constexpr std::size_t encodedSize(const std::size_t size) {
+  return (size + 2) / 3 * 4;
+}
+
+// writes the padded encoding of `in` to `out`, which has to hold
+// `encodedSize(in.size())` bytes. uses ssse3 or avx2 where available. a
+// stream can be encoded piecewise as long as all but the last piece are a
+// multiple of 3 bytes long.
+void encode(std::string_view in, char *out);
+std::string encode(std::string_view in);
+// skips characters outside of the alphabet like line breaks and stops at the
+// padding
+std::string decode(std::string_view in);
+} // namespace odr::crypto::Base64
+
+#endif // ODR_CRYPTO_BASE64_H
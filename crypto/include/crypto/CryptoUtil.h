@@ -1,13 +1,16 @@
 #ifndef ODR_CRYPTO_UTIL_H
 #define ODR_CRYPTO_UTIL_H
 
+#include <iosfwd>
 #include <string>
 
 namespace odr::crypto::Util {
 std::string base64Encode(const std::string &);
 std::string base64Decode(const std::string &);
+std::string hexEncode(const std::string &);
 std::string sha1(const std::string &);
 std::string sha256(const std::string &);
+std::string sha256(std::istream &);
 std::string pbkdf2(std::size_t keySize, const std::string &startKey,
                    const std::string &salt, std::size_t iterationCount);
 std::string decryptAES(const std::string &key, const std::string &input);
@@ -0,0 +1,203 @@
+#include <Base64Encoders.h>
+#include <array>
+#include <crypto/Base64.h>
+#include <cstdint>
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#include <immintrin.h>
+#define ODR_SIMD_X86
+// Apple clang before 12 cannot link `__builtin_cpu_supports`
+#if !defined(__apple_build_version__) || (__apple_build_version__ >= 12000000)
+#define ODR_CPU_DISPATCH
+#endif
+#endif
+
+namespace odr::crypto {
+
+namespace {
+constexpr char alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr std::uint8_t invalid = 0xff;
+
+constexpr std::array<std::uint8_t, 256> decodeTable() {
+  std::array<std::uint8_t, 256> result{};
+  for (auto &&r : result)
+    r = invalid;
+  for (std::uint8_t i = 0; i < 64; ++i)
+    result[static_cast<unsigned char>(alphabet[i])] = i;
+  return result;
+}
+
+constexpr auto sextets = decodeTable();
+
+// encodes whole groups of 3 bytes from `pos` on and pads the rest
+void encodeScalar(const std::uint8_t *in, std::size_t pos,
+                  const std::size_t size, char *out) {
+  for (; pos + 3 <= size; pos += 3) {
+    const std::uint32_t group =
+        (in[pos] << 16) | (in[pos + 1] << 8) | in[pos + 2];
+    *out++ = alphabet[(group >> 18) & 0x3f];
+    *out++ = alphabet[(group >> 12) & 0x3f];
+    *out++ = alphabet[(group >> 6) & 0x3f];
+    *out++ = alphabet[group & 0x3f];
+  }
+  if (pos == size)
+    return;
+  const std::uint32_t group =
+      (in[pos] << 16) | (pos + 1 < size ? in[pos + 1] << 8 : 0);
+  *out++ = alphabet[(group >> 18) & 0x3f];
+  *out++ = alphabet[(group >> 12) & 0x3f];
+  *out++ = pos + 1 < size ? alphabet[(group >> 6) & 0x3f] : '=';
+  *out++ = '=';
+}
+
+#ifdef ODR_SIMD_X86
+// Muła's method: spreads 12 bytes to 16 sextets with one shuffle and two
+// multiplications, then maps the sextets to ascii by adding an offset picked
+// by a second shuffle. see http://0x80.pl/articles/sse-base64-encoding.html
+__attribute__((target("ssse3"))) __m128i sextetsSsse3(const __m128i in) {
+  const __m128i spread = _mm_shuffle_epi8(
+      in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+  const __m128i high = _mm_mulhi_epu16(
+      _mm_and_si128(spread, _mm_set1_epi32(0x0fc0fc00)),
+      _mm_set1_epi32(0x04000040));
+  const __m128i low = _mm_mullo_epi16(
+      _mm_and_si128(spread, _mm_set1_epi32(0x003f03f0)),
+      _mm_set1_epi32(0x01000010));
+  return _mm_or_si128(high, low);
+}
+
+__attribute__((target("ssse3"))) __m128i asciiSsse3(const __m128i sextets) {
+  // 13 for A-Z, 0 for a-z, 1 to 10 for 0-9, 11 for + and 12 for /
+  const __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), sextets);
+  const __m128i offset =
+      _mm_or_si128(_mm_subs_epu8(sextets, _mm_set1_epi8(51)),
+                   _mm_and_si128(upper, _mm_set1_epi8(13)));
+  const __m128i offsets =
+      _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                    '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                    '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  return _mm_add_epi8(_mm_shuffle_epi8(offsets, offset), sextets);
+}
+
+__attribute__((target("ssse3"))) void
+encodeSsse3(const std::uint8_t *in, std::size_t pos, const std::size_t size,
+            char *out) {
+  // reads 16 bytes for 12
+  for (; pos + 16 <= size; pos += 12, out += 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out),
+                     asciiSsse3(sextetsSsse3(chunk)));
+  }
+  encodeScalar(in, pos, size, out);
+}
+
+// unused where neither the cpu can be asked nor the build targets avx2
+__attribute__((target("avx2"), unused)) void
+encodeAvx2(const std::uint8_t *in, std::size_t pos, const std::size_t size,
+           char *out) {
+  const __m256i spreadMask = _mm256_broadcastsi128_si256(
+      _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+  const __m256i offsets = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                    '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                    '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0));
+  // reads 28 bytes for 24; each lane takes 12 of them
+  for (; pos + 28 <= size; pos += 24, out += 32) {
+    const __m256i chunk = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos + 12)), 1);
+    const __m256i spread = _mm256_shuffle_epi8(chunk, spreadMask);
+    const __m256i high = _mm256_mulhi_epu16(
+        _mm256_and_si256(spread, _mm256_set1_epi32(0x0fc0fc00)),
+        _mm256_set1_epi32(0x04000040));
+    const __m256i low = _mm256_mullo_epi16(
+        _mm256_and_si256(spread, _mm256_set1_epi32(0x003f03f0)),
+        _mm256_set1_epi32(0x01000010));
+    const __m256i sextets = _mm256_or_si256(high, low);
+    const __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), sextets);
+    const __m256i offset =
+        _mm256_or_si256(_mm256_subs_epu8(sextets, _mm256_set1_epi8(51)),
+                        _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(out),
+        _mm256_add_epi8(_mm256_shuffle_epi8(offsets, offset), sextets));
+  }
+  encodeSsse3(in, pos, size, out);
+}
+#endif
+
+Base64::Encoders detectEncoders() {
+  Base64::Encoders result{encodeScalar, nullptr, nullptr};
+#if defined(ODR_SIMD_X86) && defined(ODR_CPU_DISPATCH)
+  if (__builtin_cpu_supports("ssse3"))
+    result.ssse3 = encodeSsse3;
+  if (__builtin_cpu_supports("avx2"))
+    result.avx2 = encodeAvx2;
+#elif defined(ODR_SIMD_X86)
+  // only what the build targets
+#ifdef __SSSE3__
+  result.ssse3 = encodeSsse3;
+#endif
+#ifdef __AVX2__
+  result.avx2 = encodeAvx2;
+#endif
+#endif
+  return result;
+}
+} // namespace
+
+const Base64::Encoders &Base64::encoders() {
+  static const Encoders result = detectEncoders();
+  return result;
+}
+
+void Base64::encode(const std::string_view in, char *out) {
+  static const Encoder encode = [] {
+    const Encoders &available = encoders();
+    if (available.avx2 != nullptr)
+      return available.avx2;
+    if (available.ssse3 != nullptr)
+      return available.ssse3;
+    return available.scalar;
+  }();
+  encode(reinterpret_cast<const std::uint8_t *>(in.data()), 0, in.size(), out);
+}
+
+std::string Base64::encode(const std::string_view in) {
+  std::string result(encodedSize(in.size()), '\0');
+  encode(in, result.data());
+  return result;
+}
+
+std::string Base64::decode(const std::string_view in) {
+  std::string result;
+  result.reserve(in.size() / 4 * 3 + 3);
+  std::uint32_t group = 0;
+  std::uint32_t count = 0;
+  for (auto &&c : in) {
+    if (c == '=')
+      break;
+    const std::uint8_t sextet = sextets[static_cast<unsigned char>(c)];
+    if (sextet == invalid)
+      continue;
+    group = (group << 6) | sextet;
+    if (++count == 4) {
+      result += static_cast<char>(group >> 16);
+      result += static_cast<char>(group >> 8);
+      result += static_cast<char>(group);
+      group = 0;
+      count = 0;
+    }
+  }
+  // 2 or 3 sextets left carry 1 or 2 bytes
+  if (count >= 2)
+    result += static_cast<char>(group >> (6 * count - 8));
+  if (count == 3)
+    result += static_cast<char>(group >> 2);
+  return result;
+}
+
+} // namespace odr::crypto
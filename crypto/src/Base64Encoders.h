@@ -0,0 +1,23 @@
+#ifndef ODR_CRYPTO_BASE64_ENCODERS_H
+#define ODR_CRYPTO_BASE64_ENCODERS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace odr::crypto::Base64 {
+// encodes whole groups of 3 bytes from `pos` on and pads the rest
+using Encoder = void (*)(const std::uint8_t *in, std::size_t pos,
+                         std::size_t size, char *out);
+
+// the variants behind `encode`, exposed for tests and benchmarks. the
+// vectorized ones are null where the compiler or the cpu lacks them
+struct Encoders final {
+  Encoder scalar;
+  Encoder ssse3;
+  Encoder avx2;
+};
+
+const Encoders &encoders();
+} // namespace odr::crypto::Base64
+
+#endif // ODR_CRYPTO_BASE64_ENCODERS_H
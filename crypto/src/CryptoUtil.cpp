@@ -1,9 +1,11 @@
 #include <aes.h>
-#include <base64.h>
 #include <blowfish.h>
+#include <crypto/Base64.h>
 #include <crypto/CryptoUtil.h>
 #include <des.h>
 #include <filters.h>
+#include <hex.h>
+#include <istream>
 #include <modes.h>
 #include <pwdbased.h>
 #include <sha.h>
@@ -14,18 +16,18 @@ namespace odr::crypto {
 typedef unsigned char byte;
 
 std::string Util::base64Encode(const std::string &in) {
-  std::string out;
-  CryptoPP::Base64Encoder b(new CryptoPP::StringSink(out), false);
-  b.Put((const byte *)in.data(), in.size());
-  b.MessageEnd();
-  return out;
+  return Base64::encode(in);
 }
 
 std::string Util::base64Decode(const std::string &in) {
+  return Base64::decode(in);
+}
+
+std::string Util::hexEncode(const std::string &in) {
   std::string out;
-  CryptoPP::Base64Decoder b(new CryptoPP::StringSink(out));
-  b.Put((const byte *)in.data(), in.size());
-  b.MessageEnd();
+  CryptoPP::HexEncoder h(new CryptoPP::StringSink(out), false);
+  h.Put((const byte *)in.data(), in.size());
+  h.MessageEnd();
   return out;
 }
 
@@ -41,6 +43,18 @@ std::string Util::sha256(const std::string &in) {
   return std::string((char *)out, CryptoPP::SHA256::DIGESTSIZE);
 }
 
+std::string Util::sha256(std::istream &in) {
+  CryptoPP::SHA256 sha;
+  char buffer[4096];
+  while (in) {
+    in.read(buffer, sizeof(buffer));
+    sha.Update((byte *)buffer, in.gcount());
+  }
+  byte out[CryptoPP::SHA256::DIGESTSIZE];
+  sha.Final(out);
+  return std::string((char *)out, CryptoPP::SHA256::DIGESTSIZE);
+}
+
 std::string Util::pbkdf2(const std::size_t keySize, const std::string &startKey,
                          const std::string &salt,
                          const std::size_t iterationCount) {
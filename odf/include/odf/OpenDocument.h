@@ -18,6 +18,9 @@ public:
   explicit OpenDocument(const access::Path &path);
   explicit OpenDocument(std::unique_ptr<access::ReadStorage> &&storage);
   explicit OpenDocument(std::unique_ptr<access::ReadStorage> &storage);
+  // skips meta parsing, e.g. for snapshots
+  OpenDocument(std::unique_ptr<access::ReadStorage> &&storage, FileMeta meta,
+               bool decrypted);
   OpenDocument(const OpenDocument &) = delete;
   OpenDocument(OpenDocument &&) noexcept;
   OpenDocument &operator=(const OpenDocument &) = delete;
@@ -38,6 +41,8 @@ public:
 
   void edit(const std::string &diff) final;
 
+  void releaseCache() noexcept final;
+
   void save(const access::Path &path) const final;
   void save(const access::Path &path, const std::string &password) const final;
 
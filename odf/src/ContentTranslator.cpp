@@ -3,63 +3,64 @@
 #include <access/Path.h>
 #include <access/Storage.h>
 #include <access/StreamUtil.h>
-#include <common/StringUtil.h>
-#include <crypto/CryptoUtil.h>
-#include <cstring>
+#include <algorithm>
+#include <common/HtmlWriter.h>
+#include <common/NameTable.h>
+#include <common/ResourceWriter.h>
 #include <glog/logging.h>
 #include <odr/Config.h>
 #include <odr/Meta.h>
 #include <pugixml.hpp>
 #include <string>
+#include <string_view>
 #include <svm/Svm2Svg.h>
-#include <unordered_map>
-#include <unordered_set>
 
 namespace odr::odf {
 
 namespace {
-void TextTranslator(const pugi::xml_text &in, std::ostream &out,
+void TextTranslator(const pugi::xml_text &in, common::HtmlWriter &out,
                     Context &context) {
-  std::string text = in.as_string();
-  common::StringUtil::findAndReplaceAll(text, "&", "&amp;");
-  common::StringUtil::findAndReplaceAll(text, "<", "&lt;");
-  common::StringUtil::findAndReplaceAll(text, ">", "&gt;");
-
   if (!context.config->editable) {
-    out << text;
+    out.text(in.as_string());
   } else {
     out << R"(<span contenteditable="true" data-odr-cid=")"
-        << context.currentTextTranslationIndex << "\">" << text << "</span>";
+        << context.currentTextTranslationIndex << "\">";
+    out.text(in.as_string());
+    out << "</span>";
     context.textTranslation[context.currentTextTranslationIndex] = in;
     ++context.currentTextTranslationIndex;
   }
 }
 
-void StyleClassTranslator(const std::string &name, std::ostream &out,
-                          Context &context) {
-  out << name;
-
-  { // handle style dependencies
-    const auto it = context.styleDependencies.find(name);
-    if (it == context.styleDependencies.end()) {
-      // TODO remove ?
-      LOG(WARNING) << "unknown style: " << name;
-    } else {
-      for (auto i = it->second.rbegin(); i != it->second.rend(); ++i) {
-        out << " " << *i;
-      }
-    }
-  }
+// text of a `common::TokenDom`, which is never used for editable output
+void TextTranslator(const std::string_view in, common::HtmlWriter &out,
+                    Context &) {
+  out.text(in);
 }
 
-void StyleClassTranslator(const pugi::xml_node &in, std::ostream &out,
+void StyleClassTranslator(const std::string &name, common::HtmlWriter &out,
                           Context &context) {
-  static std::unordered_set<std::string> styleAttributes{
-      "text:style-name",         "table:style-name",
-      "draw:style-name",         "draw:text-style-name",
-      "presentation:style-name", "draw:master-page-name",
-  };
+  context.styleClasses.write(name, out);
+}
 
+enum class StyleAttribute {
+  NONE,
+  STYLE,
+  MASTER_PAGE,
+};
+
+constexpr auto styleAttributes = common::nameTable<StyleAttribute>({
+    {"text:style-name", StyleAttribute::STYLE},
+    {"table:style-name", StyleAttribute::STYLE},
+    {"draw:style-name", StyleAttribute::STYLE},
+    {"draw:text-style-name", StyleAttribute::STYLE},
+    {"presentation:style-name", StyleAttribute::STYLE},
+    {"draw:master-page-name", StyleAttribute::MASTER_PAGE},
+});
+
+template <typename Node>
+void StyleClassTranslator(const Node &in, common::HtmlWriter &out,
+                          Context &context) {
   out << " class=\"";
 
   // TODO this is ods specific
@@ -71,33 +72,47 @@ void StyleClassTranslator(const pugi::xml_node &in, std::ostream &out,
     }
   }
   if (const auto valueTypeAttr = in.attribute("office:value-type");
-      valueTypeAttr)
-    out << "odr-value-type-" << valueTypeAttr.as_string() << " ";
+      valueTypeAttr) {
+    out << "odr-value-type-";
+    out.attribute(valueTypeAttr.as_string());
+    out << " ";
+  }
 
   for (auto &&a : in.attributes()) {
-    const std::string attribute = a.name();
-    if (styleAttributes.find(attribute) == styleAttributes.end())
+    std::string name;
+    switch (styleAttributes.find(a.name(), StyleAttribute::NONE)) {
+    case StyleAttribute::STYLE:
+      name = StyleTranslator::escapeStyleName(std::string(a.as_string()));
+      break;
+    case StyleAttribute::MASTER_PAGE:
+      name =
+          StyleTranslator::escapeMasterStyleName(std::string(a.as_string()));
+      break;
+    case StyleAttribute::NONE:
       continue;
-    std::string name = StyleTranslator::escapeStyleName(a.as_string());
-    if (attribute == "draw:master-page-name")
-      name = StyleTranslator::escapeMasterStyleName(a.as_string());
+    }
     StyleClassTranslator(name, out, context);
     out << " ";
   }
   out << "\"";
 }
 
-void ElementAttributeTranslator(const pugi::xml_node &in, std::ostream &out,
+template <typename Node>
+void ElementAttributeTranslator(const Node &in, common::HtmlWriter &out,
                                 Context &context) {
   StyleClassTranslator(in, out, context);
 }
 
-void ElementChildrenTranslator(const pugi::xml_node &in, std::ostream &out,
-                               Context &context);
-void ElementTranslator(const pugi::xml_node &in, std::ostream &out,
+void ElementChildrenTranslator(const pugi::xml_node &in,
+                               common::HtmlWriter &out, Context &context);
+void ElementChildrenTranslator(const common::TokenDom::Node &in,
+                               common::HtmlWriter &out, Context &context);
+template <typename Node>
+void ElementTranslator(const Node &in, common::HtmlWriter &out,
                        Context &context);
 
-void ParagraphTranslator(const pugi::xml_node &in, std::ostream &out,
+template <typename Node>
+void ParagraphTranslator(const Node &in, common::HtmlWriter &out,
                          Context &context) {
   out << "<p";
   ElementAttributeTranslator(in, out, context);
@@ -111,7 +126,8 @@ void ParagraphTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "</p>";
 }
 
-void SpaceTranslator(const pugi::xml_node &in, std::ostream &out, Context &) {
+template <typename Node>
+void SpaceTranslator(const Node &in, common::HtmlWriter &out, Context &) {
   const auto count = in.attribute("text:c").as_uint(1);
   if (count <= 0)
     return;
@@ -123,21 +139,26 @@ void SpaceTranslator(const pugi::xml_node &in, std::ostream &out, Context &) {
   out << "</span>";
 }
 
-void TabTranslator(const pugi::xml_node &, std::ostream &out, Context &) {
+template <typename Node>
+void TabTranslator(const Node &, common::HtmlWriter &out, Context &) {
   out << "<span class=\"odr-whitespace\">&emsp;</span>";
 }
 
-void LineBreakTranslator(const pugi::xml_node &, std::ostream &out, Context &) {
+template <typename Node>
+void LineBreakTranslator(const Node &, common::HtmlWriter &out, Context &) {
   out << "<br>";
 }
 
-void LinkTranslator(const pugi::xml_node &in, std::ostream &out,
-                    Context &context) {
+template <typename Node>
+void LinkTranslator(const Node &in, common::HtmlWriter &out, Context &context) {
   out << "<a";
   if (const auto href = in.attribute("xlink:href"); href) {
-    out << " href=\"" << href.as_string() << "\"";
+    out << " href=\"";
+    out.attribute(href.as_string());
+    out << "\"";
     // NOTE: there is a trim in java
-    if ((std::strlen(href.as_string()) > 0) && (href.as_string()[0] == '#')) {
+    if (const std::string_view value = href.as_string();
+        (value.size() > 0) && (value[0] == '#')) {
       out << " target=\"_self\"";
     }
   } else {
@@ -149,11 +170,14 @@ void LinkTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "</a>";
 }
 
-void BookmarkTranslator(const pugi::xml_node &in, std::ostream &out,
+template <typename Node>
+void BookmarkTranslator(const Node &in, common::HtmlWriter &out,
                         Context &context) {
   out << "<a";
   if (const auto id = in.attribute("text:name"); id) {
-    out << " id=\"" << id.as_string() << "\"";
+    out << " id=\"";
+    out.attribute(id.as_string());
+    out << "\"";
   } else {
     LOG(WARNING) << "empty bookmark";
   }
@@ -163,7 +187,8 @@ void BookmarkTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "</a>";
 }
 
-void FrameTranslator(const pugi::xml_node &in, std::ostream &out,
+template <typename Node>
+void FrameTranslator(const Node &in, common::HtmlWriter &out,
                      Context &context) {
   out << "<div style=\"";
 
@@ -184,39 +209,55 @@ void FrameTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "</div>";
 }
 
-void ImageTranslator(const pugi::xml_node &in, std::ostream &out,
+template <typename Node>
+void ImageTranslator(const Node &in, common::HtmlWriter &out,
                      Context &context) {
   out << "<img style=\"width:100%;height:100%\"";
 
   if (const auto hrefAttr = in.attribute("xlink:href"); hrefAttr) {
-    const std::string href = hrefAttr.as_string();
-    out << " alt=\"Error: image not found or unsupported: " << href << "\"";
+    const std::string href(hrefAttr.as_string());
+    out << " alt=\"Error: image not found or unsupported: ";
+    out.attribute(href);
+    out << "\"";
     out << " src=\"";
+    const auto mark = out.mark();
     try {
       const access::Path path{href};
+      const bool svm =
+          (href.find("ObjectReplacements", 0) != std::string::npos) ||
+          (href.find(".svm", 0) != std::string::npos);
       if (!context.storage->isFile(path)) {
         // TODO sometimes `ObjectReplacements` does not exist
-        out << path;
-      } else {
-        std::string image =
-            access::StreamUtil::read(*context.storage->read(path));
-        if ((href.find("ObjectReplacements", 0) != std::string::npos) ||
-            (href.find(".svm", 0) != std::string::npos)) {
-          std::istringstream svmIn(image);
-          std::ostringstream svgOut;
-          svm::Translator::svg(svmIn, svgOut);
-          image = svgOut.str();
-          out << "data:image/svg+xml;base64, ";
+        out.attribute(path.string());
+      } else if (!svm && (context.resources != nullptr)) {
+        out.attribute(context.resources->write(*context.storage, path));
+      } else if (svm) {
+        // the svm reader needs to tell its position
+        std::istringstream svmIn(
+            access::StreamUtil::read(*context.storage->read(path)));
+        std::ostringstream svgOut;
+        svm::Translator::svg(svmIn, svgOut);
+        if (context.resources != nullptr) {
+          out.attribute(context.resources->write(path.string() + ".svg",
+                                                 svgOut.str()));
         } else {
-          // hacky image/jpg working according to tom
-          out << "data:image/jpg;base64, ";
+          out << "data:image/svg+xml;base64, ";
+          out.base64(svgOut.str());
         }
-        out << crypto::Util::base64Encode(image);
+      } else {
+        // hacky image/jpg working according to tom
+        out << "data:image/jpg;base64, ";
+        out.base64(*context.storage->read(path));
       }
     } catch (...) {
-      out << href;
+      // half a url that already reached the sink cannot be taken back
+      if (!out.rollback(mark))
+        throw;
+      out.attribute(href);
     }
     out << "\"";
+    if (context.resources != nullptr)
+      out << " loading=\"lazy\"";
   } else {
     out << " alt=\"Error: image path not specified";
     LOG(ERROR) << "image href not found";
@@ -229,8 +270,9 @@ void ImageTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "</img>";
 }
 
-void TableTranslator(const pugi::xml_node &in, std::ostream &out,
-                     Context &context) {
+template <typename Node>
+void TableBeginTranslator(const Node &in, common::HtmlWriter &out,
+                          Context &context) {
   context.tableRange = {
       {context.config->tableOffsetRows, context.config->tableOffsetCols},
       context.config->tableLimitRows,
@@ -239,10 +281,11 @@ void TableTranslator(const pugi::xml_node &in, std::ostream &out,
   // TODO remove file check; add simple table translator for odt/odp
   if ((context.meta->type == FileType::OPENDOCUMENT_SPREADSHEET) &&
       context.config->tableLimitByDimensions) {
+    // the limits count from the offset, the dimensions from the origin
     const common::TablePosition end{
-        std::min(context.config->tableLimitRows,
+        std::min(context.tableRange.to().row(),
                  context.meta->entries[context.entry].rowCount),
-        std::min(context.config->tableLimitCols,
+        std::min(context.tableRange.to().col(),
                  context.meta->entries[context.entry].columnCount)};
 
     context.tableRange = {context.tableRange.from(), end};
@@ -255,18 +298,35 @@ void TableTranslator(const pugi::xml_node &in, std::ostream &out,
   ElementAttributeTranslator(in, out, context);
   out << R"( cellpadding="0" border="0" cellspacing="0")";
   out << ">";
-  ElementChildrenTranslator(in, out, context);
+}
+
+void TableEndTranslator(common::HtmlWriter &out, Context &context) {
   out << "</table>";
 
   ++context.entry;
 }
 
-void TableColumnTranslator(const pugi::xml_node &in, std::ostream &out,
+template <typename Node>
+void TableTranslator(const Node &in, common::HtmlWriter &out,
+                     Context &context) {
+  TableBeginTranslator(in, out, context);
+  ElementChildrenTranslator(in, out, context);
+  TableEndTranslator(out, context);
+}
+
+template <typename Node>
+void TableColumnTranslator(const Node &in, common::HtmlWriter &out,
                            Context &context) {
-  const auto repeated =
-      in.attribute("table:number-columns-repeated").as_uint(1);
+  auto repeated = in.attribute("table:number-columns-repeated").as_uint(1);
   const auto defaultCellStyleAttribute =
       in.attribute("table:default-cell-style-name");
+  // columns before the table range produce no output
+  if (context.tableCursor.col() < context.tableRange.from().col()) {
+    const auto skip = std::min(
+        repeated, context.tableRange.from().col() - context.tableCursor.col());
+    context.tableCursor.addCol(skip);
+    repeated -= skip;
+  }
   // TODO we could use span instead
   for (std::uint32_t i = 0; i < repeated; ++i) {
     if (context.tableCursor.col() >= context.tableRange.to().col())
@@ -283,10 +343,19 @@ void TableColumnTranslator(const pugi::xml_node &in, std::ostream &out,
   }
 }
 
-void TableRowTranslator(const pugi::xml_node &in, std::ostream &out,
+template <typename Node>
+void TableRowTranslator(const Node &in, common::HtmlWriter &out,
                         Context &context) {
-  const auto repeated = in.attribute("table:number-rows-repeated").as_uint(1);
+  auto repeated = in.attribute("table:number-rows-repeated").as_uint(1);
   context.tableCursor.addRow(0); // TODO hacky
+  // rows before the table range produce no output; a long run is skipped at
+  // once instead of row by row
+  if (context.tableCursor.row() < context.tableRange.from().row()) {
+    const auto skip = std::min(
+        repeated, context.tableRange.from().row() - context.tableCursor.row());
+    context.tableCursor.addRow(skip);
+    repeated -= skip;
+  }
   for (std::uint32_t i = 0; i < repeated; ++i) {
     if (context.tableCursor.row() >= context.tableRange.to().row())
       break;
@@ -301,7 +370,8 @@ void TableRowTranslator(const pugi::xml_node &in, std::ostream &out,
   }
 }
 
-void TableCellTranslator(const pugi::xml_node &in, std::ostream &out,
+template <typename Node>
+void TableCellTranslator(const Node &in, common::HtmlWriter &out,
                          Context &context) {
   const auto repeated =
       in.attribute("table:number-columns-repeated").as_uint(1);
@@ -326,7 +396,8 @@ void TableCellTranslator(const pugi::xml_node &in, std::ostream &out,
   }
 }
 
-void DrawLineTranslator(const pugi::xml_node &in, std::ostream &out,
+template <typename Node>
+void DrawLineTranslator(const Node &in, common::HtmlWriter &out,
                         Context &context) {
   const auto x1 = in.attribute("svg:x1");
   const auto y1 = in.attribute("svg:y1");
@@ -352,7 +423,8 @@ void DrawLineTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "</svg>";
 }
 
-void DrawRectTranslator(const pugi::xml_node &in, std::ostream &out,
+template <typename Node>
+void DrawRectTranslator(const Node &in, common::HtmlWriter &out,
                         Context &context) {
   out << "<div style=\"";
 
@@ -374,7 +446,8 @@ void DrawRectTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "</div>";
 }
 
-void DrawCircleTranslator(const pugi::xml_node &in, std::ostream &out,
+template <typename Node>
+void DrawCircleTranslator(const Node &in, common::HtmlWriter &out,
                           Context &context) {
   out << "<div style=\"";
 
@@ -396,8 +469,8 @@ void DrawCircleTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "</div>";
 }
 
-void ElementChildrenTranslator(const pugi::xml_node &in, std::ostream &out,
-                               Context &context) {
+void ElementChildrenTranslator(const pugi::xml_node &in,
+                               common::HtmlWriter &out, Context &context) {
   for (auto &&n : in) {
     if (n.type() == pugi::node_pcdata)
       TextTranslator(n.text(), out, context);
@@ -406,71 +479,151 @@ void ElementChildrenTranslator(const pugi::xml_node &in, std::ostream &out,
   }
 }
 
-void ElementTranslator(const pugi::xml_node &in, std::ostream &out,
+void ElementChildrenTranslator(const common::TokenDom::Node &in,
+                               common::HtmlWriter &out, Context &context) {
+  for (auto &&n : in) {
+    if (n.isText())
+      TextTranslator(n.text(), out, context);
+    else if (n.isElement())
+      ElementTranslator(n, out, context);
+  }
+}
+
+enum class Element {
+  UNKNOWN,
+  SKIP,
+  PARAGRAPH,
+  SPACE,
+  TAB,
+  LINE_BREAK,
+  LINK,
+  BOOKMARK,
+  FRAME,
+  IMAGE,
+  TABLE,
+  TABLE_COLUMN,
+  TABLE_ROW,
+  TABLE_CELL,
+  DRAW_LINE,
+  DRAW_RECT,
+  DRAW_CIRCLE,
+  // substituted by a plain html element
+  SPAN,
+  LIST,
+  LIST_ITEM,
+  PAGE,
+};
+
+constexpr auto elements = common::nameTable<Element>({
+    {"text:p", Element::PARAGRAPH},
+    {"text:h", Element::PARAGRAPH},
+    {"text:s", Element::SPACE},
+    {"text:tab", Element::TAB},
+    {"text:line-break", Element::LINE_BREAK},
+    {"text:a", Element::LINK},
+    {"text:bookmark", Element::BOOKMARK},
+    {"text:bookmark-start", Element::BOOKMARK},
+    {"draw:frame", Element::FRAME},
+    {"draw:custom-shape", Element::FRAME},
+    {"draw:image", Element::IMAGE},
+    {"table:table", Element::TABLE},
+    {"table:table-column", Element::TABLE_COLUMN},
+    {"table:table-row", Element::TABLE_ROW},
+    {"table:table-cell", Element::TABLE_CELL},
+    {"draw:line", Element::DRAW_LINE},
+    {"draw:rect", Element::DRAW_RECT},
+    {"draw:circle", Element::DRAW_CIRCLE},
+    {"text:span", Element::SPAN},
+    {"text:list", Element::LIST},
+    {"text:list-item", Element::LIST_ITEM},
+    {"draw:page", Element::PAGE},
+    {"svg:desc", Element::SKIP},
+    // odt
+    {"text:index-title-template", Element::SKIP},
+    // odp
+    {"presentation:notes", Element::SKIP},
+    // ods
+    {"office:annotation", Element::SKIP},
+    {"table:tracked-changes", Element::SKIP},
+    {"table:covered-table-cell", Element::SKIP},
+});
+
+template <typename Node>
+void ElementTranslator(const Node &in, common::HtmlWriter &out,
                        Context &context) {
-  static std::unordered_map<std::string, const char *> substitution{
-      {"text:span", "span"},
-      {"text:list", "ul"},
-      {"text:list-item", "li"},
-      {"draw:page", "div"},
-  };
-  static std::unordered_set<std::string> skippers{
-      "svg:desc",
-      // odt
-      "text:index-title-template",
-      // odp
-      "presentation:notes",
-      // ods
-      "office:annotation",
-      "table:tracked-changes",
-      "table:covered-table-cell",
-  };
-
-  const std::string element = in.name();
-  if (skippers.find(element) != skippers.end())
+  const char *substitution = nullptr;
+  switch (elements.find(in.name(), Element::UNKNOWN)) {
+  case Element::SKIP:
     return;
-
-  if (element == "text:p" || element == "text:h")
+  case Element::PARAGRAPH:
     ParagraphTranslator(in, out, context);
-  else if (element == "text:s")
+    return;
+  case Element::SPACE:
     SpaceTranslator(in, out, context);
-  else if (element == "text:tab")
+    return;
+  case Element::TAB:
     TabTranslator(in, out, context);
-  else if (element == "text:line-break")
+    return;
+  case Element::LINE_BREAK:
     LineBreakTranslator(in, out, context);
-  else if (element == "text:a")
+    return;
+  case Element::LINK:
     LinkTranslator(in, out, context);
-  else if (element == "text:bookmark" || element == "text:bookmark-start")
+    return;
+  case Element::BOOKMARK:
     BookmarkTranslator(in, out, context);
-  else if (element == "draw:frame" || element == "draw:custom-shape")
+    return;
+  case Element::FRAME:
     FrameTranslator(in, out, context);
-  else if (element == "draw:image")
+    return;
+  case Element::IMAGE:
     ImageTranslator(in, out, context);
-  else if (element == "table:table")
+    return;
+  case Element::TABLE:
     TableTranslator(in, out, context);
-  else if (element == "table:table-column")
+    return;
+  case Element::TABLE_COLUMN:
     TableColumnTranslator(in, out, context);
-  else if (element == "table:table-row")
+    return;
+  case Element::TABLE_ROW:
     TableRowTranslator(in, out, context);
-  else if (element == "table:table-cell")
+    return;
+  case Element::TABLE_CELL:
     TableCellTranslator(in, out, context);
-  else if (element == "draw:line")
+    return;
+  case Element::DRAW_LINE:
     DrawLineTranslator(in, out, context);
-  else if (element == "draw:rect")
+    return;
+  case Element::DRAW_RECT:
     DrawRectTranslator(in, out, context);
-  else if (element == "draw:circle")
+    return;
+  case Element::DRAW_CIRCLE:
     DrawCircleTranslator(in, out, context);
-  else {
-    const auto it = substitution.find(element);
-    if (it != substitution.end()) {
-      out << "<" << it->second;
-      ElementAttributeTranslator(in, out, context);
-      out << ">";
-    }
-    ElementChildrenTranslator(in, out, context);
-    if (it != substitution.end())
-      out << "</" << it->second << ">";
+    return;
+  case Element::SPAN:
+    substitution = "span";
+    break;
+  case Element::LIST:
+    substitution = "ul";
+    break;
+  case Element::LIST_ITEM:
+    substitution = "li";
+    break;
+  case Element::PAGE:
+    substitution = "div";
+    break;
+  case Element::UNKNOWN:
+    break;
   }
+
+  if (substitution != nullptr) {
+    out << "<" << substitution;
+    ElementAttributeTranslator(in, out, context);
+    out << ">";
+  }
+  ElementChildrenTranslator(in, out, context);
+  if (substitution != nullptr)
+    out << "</" << substitution << ">";
 }
 } // namespace
 
@@ -478,4 +631,22 @@ void ContentTranslator::html(const pugi::xml_node &in, Context &context) {
   ElementTranslator(in, *context.output, context);
 }
 
+void ContentTranslator::html(const common::TokenDom::Node &in,
+                             Context &context) {
+  ElementTranslator(in, *context.output, context);
+}
+
+void ContentTranslator::children(const pugi::xml_node &in, Context &context) {
+  ElementChildrenTranslator(in, *context.output, context);
+}
+
+void ContentTranslator::tableBegin(const pugi::xml_node &in,
+                                   Context &context) {
+  TableBeginTranslator(in, *context.output, context);
+}
+
+void ContentTranslator::tableEnd(Context &context) {
+  TableEndTranslator(*context.output, context);
+}
+
 } // namespace odr::odf
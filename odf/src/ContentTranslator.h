@@ -1,6 +1,7 @@
 #ifndef ODR_ODF_CONTENT_TRANSLATOR_H
 #define ODR_ODF_CONTENT_TRANSLATOR_H
 
+#include <common/TokenDom.h>
 #include <memory>
 
 namespace pugi {
@@ -13,6 +14,14 @@ struct Context;
 
 namespace ContentTranslator {
 void html(const pugi::xml_node &in, Context &context);
+// same output from a `common::TokenDom`, see `Config::tokenDom`
+void html(const common::TokenDom::Node &in, Context &context);
+
+// parts of `html` for `StreamTranslator`
+void children(const pugi::xml_node &in, Context &context);
+// `in` without children
+void tableBegin(const pugi::xml_node &in, Context &context);
+void tableEnd(Context &context);
 } // namespace ContentTranslator
 
 } // namespace odr::odf
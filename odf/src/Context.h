@@ -1,6 +1,7 @@
 #ifndef ODR_ODF_CONTEXT_H
 #define ODR_ODF_CONTEXT_H
 
+#include <common/StyleClasses.h>
 #include <common/TableCursor.h>
 #include <common/TableRange.h>
 #include <iostream>
@@ -21,6 +22,12 @@ struct FileMeta;
 namespace access {
 class ReadStorage;
 }
+
+namespace common {
+class HtmlWriter;
+class ResourceWriter;
+class XmlCache;
+}
 } // namespace odr
 
 namespace odr::odf {
@@ -30,10 +37,15 @@ struct Context {
   const FileMeta *meta;
 
   const access::ReadStorage *storage;
+  common::XmlCache *xmlCache;
 
-  std::ostream *output;
+  common::HtmlWriter *output;
+  // side files of `Config::resourcePath`; null to inline the resources
+  common::ResourceWriter *resources{nullptr};
 
   std::unordered_map<std::string, std::list<std::string>> styleDependencies;
+  // `styleDependencies` resolved once the styles are translated
+  common::StyleClasses styleClasses;
 
   std::uint32_t entry{0};
   common::TableRange tableRange;
@@ -3,12 +3,16 @@
 #include <access/StorageUtil.h>
 #include <common/MapUtil.h>
 #include <common/TableCursor.h>
+#include <common/XmlPullParser.h>
 #include <common/XmlUtil.h>
 #include <crypto/CryptoUtil.h>
+#include <cstdlib>
 #include <cstring>
 #include <odr/Meta.h>
 #include <pugixml.hpp>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace odr::odf {
 
@@ -99,38 +103,168 @@ bool lookupStartKeyTypes(const std::string &checksum,
       STARTKEY_TYPES, checksum, checksumType, Meta::ChecksumType::UNKNOWN);
 }
 
-void estimateTableDimensions(const pugi::xml_node &table, std::uint32_t &rows,
+using Event = common::XmlPullParser::Event;
+
+std::uint32_t uintAttribute(const common::XmlPullParser &parser,
+                            const char *name, const std::uint32_t fallback) {
+  const char *value = parser.attribute(name);
+  if (value == nullptr)
+    return fallback;
+  return std::strtoul(value, nullptr, 10);
+}
+
+void parseTable(common::XmlPullParser &parser,
+                std::vector<FileMeta::Entry> &entries);
+
+// consumes everything up to the end of the open element at `depth`; tables on
+// the way are appended to `entries`
+void close(common::XmlPullParser &parser, const std::uint32_t depth,
+           std::vector<FileMeta::Entry> &entries) {
+  while (parser.depth() >= depth) {
+    if ((parser.event() == Event::START_ELEMENT) &&
+        (parser.name() == "table:table")) {
+      parseTable(parser, entries);
+      continue;
+    }
+    if (parser.next() == Event::END_DOCUMENT)
+      throw common::NotXmlException();
+  }
+}
+
+// consumes the table at the current start element. only row containers, rows
+// and cells are counted; nested tables are appended to `entries` and do not
+// count. cells past the limits are only searched for nested tables.
+void estimateTableDimensions(common::XmlPullParser &parser, std::uint32_t &rows,
                              std::uint32_t &cols, const std::uint32_t limitRows,
-                             const std::uint32_t limitCols) {
+                             const std::uint32_t limitCols,
+                             std::vector<FileMeta::Entry> &entries) {
+  static const std::unordered_set<std::string> rowContainers{
+      "table:table-header-rows",
+      "table:table-rows",
+      "table:table-row-group",
+  };
+
   rows = 0;
   cols = 0;
 
   common::TableCursor tl;
+  const std::uint32_t tableDepth = parser.depth();
+  std::uint32_t rowDepth = 0;
+
+  while (true) {
+    switch (parser.next()) {
+    case Event::START_ELEMENT:
+      if (parser.name() == "table:table-row") {
+        // repeated empty rows are a single step
+        tl.addRow(uintAttribute(parser, "table:number-rows-repeated", 1));
+        // the cursor only grows
+        if (tl.row() >= limitRows) {
+          close(parser, tableDepth, entries);
+          return;
+        }
+        rowDepth = parser.depth();
+      } else if (parser.name() == "table:table-cell") {
+        tl.addCell(uintAttribute(parser, "table:number-columns-spanned", 1),
+                   uintAttribute(parser, "table:number-rows-spanned", 1),
+                   uintAttribute(parser, "table:number-columns-repeated", 1));
+        const std::uint32_t cellDepth = parser.depth();
+        const bool empty = parser.next() == Event::END_ELEMENT;
+        close(parser, cellDepth, entries);
+
+        const auto newRows = tl.row();
+        const auto newCols = std::max(cols, tl.col());
+        if (!empty && (newRows < limitRows) && (newCols < limitCols)) {
+          rows = newRows;
+          cols = newCols;
+        }
+        // the rest of the row is past the limit
+        if (tl.col() >= limitCols)
+          close(parser, rowDepth, entries);
+      } else if (rowContainers.find(parser.name()) == rowContainers.end()) {
+        close(parser, parser.depth(), entries);
+      }
+      break;
+    case Event::END_ELEMENT:
+      if (parser.depth() < tableDepth)
+        return;
+      break;
+    case Event::END_DOCUMENT:
+      throw common::NotXmlException();
+    default:
+      break;
+    }
+  }
+}
+
+// consumes the table at the current start element and appends its entry
+// followed by those of its nested tables
+void parseTable(common::XmlPullParser &parser,
+                std::vector<FileMeta::Entry> &entries) {
+  const std::size_t index = entries.size();
+  entries.emplace_back();
+  if (const char *name = parser.attribute("table:name"); name != nullptr)
+    entries[index].name = name;
+  std::uint32_t rows = 0;
+  std::uint32_t cols = 0;
+  // TODO configuration
+  estimateTableDimensions(parser, rows, cols, 10000, 500, entries);
+  entries[index].rowCount = rows;
+  entries[index].columnCount = cols;
+}
+
+// reads `office:body` and fills in its entries without building a DOM
+void parseBody(common::XmlPullParser &parser, FileMeta &result) {
+  if ((parser.next() != Event::START_ELEMENT) ||
+      (parser.name() != "office:document-content"))
+    throw NoOpenDocumentFileException();
+  while (true) {
+    const Event event = parser.next();
+    if ((event == Event::END_ELEMENT) || (event == Event::END_DOCUMENT))
+      throw NoOpenDocumentFileException();
+    if (event != Event::START_ELEMENT)
+      continue;
+    if (parser.name() == "office:body")
+      break;
+    parser.skip();
+  }
+
+  const std::uint32_t bodyDepth = parser.depth();
+  switch (result.type) {
+  case FileType::OPENDOCUMENT_GRAPHICS:
+  case FileType::OPENDOCUMENT_PRESENTATION:
+  case FileType::OPENDOCUMENT_SPREADSHEET:
+    result.entryCount = 0;
+    break;
+  default:
+    return;
+  }
 
-  auto range = table.select_nodes(
-      ".//self::table:table-row | .//self::table:table-cell");
-  range.sort();
-  for (auto &&e : range) {
-    const auto &&n = e.node();
-    if (std::strcmp(n.name(), "table:table-row") == 0) {
-      const auto repeated =
-          n.attribute("table:number-rows-repeated").as_uint(1);
-      tl.addRow(repeated);
-    } else if (std::strcmp(n.name(), "table:table-cell") == 0) {
-      const auto repeated =
-          n.attribute("table:number-columns-repeated").as_uint(1);
-      const auto colspan =
-          n.attribute("table:number-columns-spanned").as_uint(1);
-      const auto rowspan = n.attribute("table:number-rows-spanned").as_uint(1);
-      tl.addCell(colspan, rowspan, repeated);
-
-      const auto newRows = tl.row();
-      const auto newCols = std::max(cols, tl.col());
-      if (n.first_child() && (((limitRows != 0) && (newRows < limitRows)) &&
-                              ((limitCols != 0) && (newCols < limitCols)))) {
-        rows = newRows;
-        cols = newCols;
+  while (true) {
+    switch (parser.next()) {
+    case Event::START_ELEMENT:
+      if ((result.type == FileType::OPENDOCUMENT_SPREADSHEET) &&
+          (parser.name() == "table:table")) {
+        parseTable(parser, result.entries);
+        result.entryCount =
+            static_cast<std::uint32_t>(result.entries.size());
+      } else if ((result.type != FileType::OPENDOCUMENT_SPREADSHEET) &&
+                 (parser.name() == "draw:page")) {
+        ++result.entryCount;
+        FileMeta::Entry entry;
+        if (const char *name = parser.attribute("draw:name"); name != nullptr)
+          entry.name = name;
+        result.entries.emplace_back(entry);
+        parser.skip();
       }
+      break;
+    case Event::END_ELEMENT:
+      if (parser.depth() < bodyDepth)
+        return;
+      break;
+    case Event::END_DOCUMENT:
+      throw common::NotXmlException();
+    default:
+      break;
     }
   }
 }
@@ -198,39 +332,11 @@ FileMeta Meta::parseFileMeta(const access::ReadStorage &storage,
       }
     }
 
-    // TODO dont load content twice (happens in case of translation)
-    const auto contentXml = common::XmlUtil::parse(storage, "content.xml");
-    const auto body =
-        contentXml.child("office:document-content").child("office:body");
-    if (!body)
+    const auto contentIn = storage.read("content.xml");
+    if (!contentIn)
       throw NoOpenDocumentFileException();
-
-    switch (result.type) {
-    case FileType::OPENDOCUMENT_GRAPHICS:
-    case FileType::OPENDOCUMENT_PRESENTATION: {
-      result.entryCount = 0;
-      for (auto &&e : body.select_nodes("//draw:page")) {
-        ++result.entryCount;
-        FileMeta::Entry entry;
-        entry.name = e.node().attribute("draw:name").as_string();
-        result.entries.emplace_back(entry);
-      }
-    } break;
-    case FileType::OPENDOCUMENT_SPREADSHEET: {
-      result.entryCount = 0;
-      for (auto &&e : body.select_nodes("//table:table")) {
-        ++result.entryCount;
-        FileMeta::Entry entry;
-        entry.name = e.node().attribute("table:name").as_string();
-        // TODO configuration
-        estimateTableDimensions(e.node(), entry.rowCount, entry.columnCount,
-                                10000, 500);
-        result.entries.emplace_back(entry);
-      }
-    } break;
-    default:
-      break;
-    }
+    common::XmlPullParser parser(*contentIn);
+    parseBody(parser, result);
   }
 
   return result;
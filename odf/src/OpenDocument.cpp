@@ -2,71 +2,110 @@
 #include <Context.h>
 #include <Crypto.h>
 #include <Meta.h>
+#include <StreamTranslator.h>
 #include <StyleTranslator.h>
+#include <access/StorageUtil.h>
 #include <access/StreamUtil.h>
 #include <access/ZipStorage.h>
 #include <common/Html.h>
-#include <common/XmlUtil.h>
+#include <common/HtmlWriter.h>
+#include <common/ResourceWriter.h>
+#include <common/StyleSheet.h>
+#include <common/TokenDom.h>
+#include <common/XmlCache.h>
+#include <common/XmlPullParser.h>
 #include <fstream>
 #include <nlohmann/json.hpp>
 #include <odf/OpenDocument.h>
 #include <odr/Config.h>
 #include <odr/Meta.h>
 #include <pugixml.hpp>
+#include <sstream>
+#include <unordered_set>
 
 namespace odr::odf {
 
 namespace {
-void generateStyle_(std::ofstream &out, Context &context) {
+std::shared_ptr<const common::StyleSheet> documentStyle_(Context &context) {
+  // shared by all documents with the same `styles.xml`, e.g. from a template
+  return common::StyleSheetCache::instance().get(
+      common::StyleSheetCache::key("odf", *context.storage, "styles.xml"),
+      [&]() {
+        return common::StyleSheet::compile(context, [&]() {
+          const auto stylesXml = context.xmlCache->get("styles.xml");
+          const auto documentStyles =
+              stylesXml->child("office:document-styles");
+
+          const auto fontFaceDecls =
+              documentStyles.child("office:font-face-decls");
+          if (fontFaceDecls)
+            StyleTranslator::css(fontFaceDecls, context);
+
+          const auto styles = documentStyles.child("office:styles");
+          if (styles)
+            StyleTranslator::css(styles, context);
+
+          const auto automaticStyles =
+              documentStyles.child("office:automatic-styles");
+          if (automaticStyles)
+            StyleTranslator::css(automaticStyles, context);
+
+          const auto masterStyles =
+              documentStyles.child("office:master-styles");
+          if (masterStyles)
+            StyleTranslator::css(masterStyles, context);
+        });
+      });
+}
+
+void generateStyle_(common::HtmlWriter &out, Context &context,
+                    const common::StyleSheet &documentStyle,
+                    const common::StyleSheet &contentStyle) {
   out << common::Html::odfDefaultStyle();
 
   if (context.meta->type == FileType::OPENDOCUMENT_SPREADSHEET)
     out << common::Html::odfSpreadsheetDefaultStyle();
 
-  const auto stylesXml = common::XmlUtil::parse(*context.storage, "styles.xml");
-
-  const auto fontFaceDecls =
-      stylesXml.child("office:document-styles").child("office:font-face-decls");
-  if (fontFaceDecls)
-    StyleTranslator::css(fontFaceDecls, context);
-
-  const auto styles =
-      stylesXml.child("office:document-styles").child("office:styles");
-  if (styles)
-    StyleTranslator::css(styles, context);
-
-  const auto automaticStyles = stylesXml.child("office:document-styles")
-                                   .child("office:automatic-styles");
-  if (automaticStyles)
-    StyleTranslator::css(automaticStyles, context);
-
-  const auto masterStyles =
-      stylesXml.child("office:document-styles").child("office:master-styles");
-  if (masterStyles)
-    StyleTranslator::css(masterStyles, context);
+  std::unordered_set<std::string> used;
+  if (context.config->pruneStyles)
+    used = context.styleClasses.used(context.styleDependencies);
+  if (context.config->flattenStyles) {
+    context.styleClasses.css(out,
+                             context.config->pruneStyles ? &used : nullptr);
+  } else if (context.config->pruneStyles) {
+    out << documentStyle.prune(used);
+    out << contentStyle.prune(used);
+  } else {
+    out << documentStyle.css;
+    out << contentStyle.css;
+  }
 }
 
-void generateContentStyle_(const pugi::xml_node &in, Context &context) {
-  const auto fontFaceDecls =
-      in.child("office:document-content").child("office:font-face-decls");
-  if (fontFaceDecls)
-    StyleTranslator::css(fontFaceDecls, context);
-
-  const auto automaticStyles =
-      in.child("office:document-content").child("office:automatic-styles");
-  if (automaticStyles)
-    StyleTranslator::css(automaticStyles, context);
+common::StyleSheet compileContentStyle_(const pugi::xml_node &in,
+                                        Context &context) {
+  return common::StyleSheet::compile(context, [&]() {
+    const auto fontFaceDecls =
+        in.child("office:document-content").child("office:font-face-decls");
+    if (fontFaceDecls)
+      StyleTranslator::css(fontFaceDecls, context);
+
+    const auto automaticStyles =
+        in.child("office:document-content").child("office:automatic-styles");
+    if (automaticStyles)
+      StyleTranslator::css(automaticStyles, context);
+  });
 }
 
-void generateScript_(std::ofstream &out, Context &) {
+void generateScript_(common::HtmlWriter &out, Context &) {
   out << common::Html::defaultScript();
 }
 
-void generateContent_(const pugi::xml_node &in, Context &context) {
-  const pugi::xml_node body =
-      in.child("office:document-content").child("office:body");
+// `Node` is a `pugi::xml_node` or a `common::TokenDom::Node`
+template <typename Node>
+void generateContent_(const Node &in, Context &context) {
+  const Node body = in.child("office:document-content").child("office:body");
 
-  pugi::xml_node content;
+  Node content;
   std::string entryName;
   switch (context.meta->type) {
   case FileType::OPENDOCUMENT_TEXT:
@@ -125,6 +164,7 @@ public:
     manifest_ = Meta::parseManifest(*storage);
 
     storage_ = std::move(storage);
+    xmlCache_.setStorage(storage_.get());
   }
 
   explicit Impl(std::unique_ptr<access::ReadStorage> &storage) {
@@ -132,6 +172,16 @@ public:
     manifest_ = Meta::parseManifest(*storage);
 
     storage_ = std::move(storage);
+    xmlCache_.setStorage(storage_.get());
+  }
+
+  Impl(std::unique_ptr<access::ReadStorage> &&storage, FileMeta meta,
+       const bool decrypted)
+      : meta_{std::move(meta)}, decrypted_{decrypted} {
+    manifest_ = Meta::parseManifest(*storage);
+
+    storage_ = std::move(storage);
+    xmlCache_.setStorage(storage_.get());
   }
 
   FileType type() const noexcept { return meta_.type; }
@@ -158,36 +208,119 @@ public:
     // TODO throw if not encrypted
     // TODO throw if decrypted
     const bool success = Crypto::decrypt(storage_, manifest_, password);
-    if (success)
+    if (success) {
       meta_ = Meta::parseFileMeta(*storage_, true);
+      xmlCache_.setStorage(storage_.get());
+      contentStyle_.reset();
+      contentDom_.reset();
+      sheetIndex_.reset();
+    }
     decrypted_ = success;
     return success;
   }
 
   bool translate(const access::Path &path, const Config &config) {
     // TODO throw if not decrypted
-    std::ofstream out(path);
-    if (!out.is_open())
+    std::ofstream file(path);
+    if (!file.is_open())
       return false;
+    common::HtmlWriter out(file);
     context_.config = &config;
     context_.meta = &meta_;
     context_.storage = storage_.get();
+    context_.xmlCache = &xmlCache_;
     context_.output = &out;
-
-    content_ = common::XmlUtil::parse(*storage_, "content.xml");
+    std::unique_ptr<common::ResourceWriter> resources;
+    if (!config.resourcePath.empty())
+      resources = std::make_unique<common::ResourceWriter>(
+          config.resourcePath, path.parent().string());
+    context_.resources = resources.get();
+
+    xmlCache_.setLimit(config.xmlCacheLimit);
+    // edits live in our copy of the content until saved
+    const bool streaming = config.streaming && !config.editable && !edited_;
+    // single sheets are read from their range of `content.xml`; windows of
+    // rows from the closest row mark
+    const bool indexed = streaming &&
+                         (meta_.type == FileType::OPENDOCUMENT_SPREADSHEET) &&
+                         ((config.entryOffset > 0) || (config.entryCount > 0));
+    if (indexed && !sheetIndex_)
+      buildSheetIndex_();
+    // edits live in the pugixml tree as well
+    const bool tokenDom =
+        config.tokenDom && !streaming && !config.editable && !edited_;
+    std::unique_ptr<std::istream> contentIn;
+    std::unique_ptr<common::XmlPullParser> contentParser;
+    pugi::xml_document contentHead;
+    if (streaming && !(indexed && contentStyle_)) {
+      contentIn = storage_->read("content.xml");
+      if (!contentIn)
+        throw access::FileNotFoundException("content.xml");
+      contentParser = std::make_unique<common::XmlPullParser>(*contentIn);
+      contentHead = StreamTranslator::head(*contentParser);
+    } else if (tokenDom) {
+      if (!contentDom_ || !contentStyle_) {
+        std::string xml = access::StorageUtil::read(*storage_, "content.xml");
+        // the styles still come from pugixml; the head is a small part
+        if (!contentStyle_) {
+          std::istringstream headIn(xml);
+          common::XmlPullParser headParser(headIn);
+          contentHead = StreamTranslator::head(headParser);
+        }
+        if (!contentDom_)
+          contentDom_ = std::make_unique<common::TokenDom>(std::move(xml));
+      }
+    } else if (!edited_) {
+      content_ = xmlCache_.get("content.xml");
+    }
 
     out << common::Html::doctype();
     out << "<html><head>";
     out << common::Html::defaultHeaders();
-    out << "<style>";
-    generateStyle_(out, context_);
-    generateContentStyle_(content_, context_);
-    out << "</style>";
-    out << "</head>";
-
-    out << "<body " << common::Html::bodyAttributes(config) << ">";
-    generateContent_(content_, context_);
-    out << "</body>";
+    context_.styleDependencies.clear();
+    if (!contentStyle_)
+      contentStyle_ = std::make_unique<common::StyleSheet>(compileContentStyle_(
+          (streaming || tokenDom) ? contentHead : *content_, context_));
+    const auto documentStyle = documentStyle_(context_);
+    documentStyle->link(context_);
+    contentStyle_->link(context_);
+    if (config.flattenStyles)
+      context_.styleClasses.flatten({documentStyle.get(), contentStyle_.get()},
+                                    context_.styleDependencies);
+    else
+      context_.styleClasses.resolve(context_.styleDependencies);
+
+    const auto generateHead = [&]() {
+      out << "<style>";
+      generateStyle_(out, context_, *documentStyle, *contentStyle_);
+      out << "</style>";
+      out << "</head>";
+    };
+    const auto generateBody = [&]() {
+      common::HtmlWriter &body = *context_.output;
+      body << "<body " << common::Html::bodyAttributes(config) << ">";
+      if (indexed)
+        translateSheets_(config);
+      else if (streaming)
+        StreamTranslator::html(*contentParser, context_);
+      else if (tokenDom)
+        generateContent_(contentDom_->document(), context_);
+      else
+        generateContent_<pugi::xml_node>(*content_, context_);
+      body << "</body>";
+    };
+    if (config.pruneStyles) {
+      // the body goes first to learn which styles it uses
+      common::HtmlWriter body;
+      context_.output = &body;
+      generateBody();
+      context_.output = &out;
+      generateHead();
+      out << body.str();
+    } else {
+      generateHead();
+      generateBody();
+    }
 
     out << "<script>";
     generateScript_(out, context_);
@@ -196,7 +329,12 @@ public:
 
     context_.config = nullptr;
     context_.output = nullptr;
-    out.close();
+    context_.resources = nullptr;
+    // the tree is kept under the same limit as the parsed parts
+    if (contentDom_ && (contentDom_->memory() > config.xmlCacheLimit))
+      contentDom_.reset();
+    out.flush();
+    file.close();
     return true;
   }
 
@@ -211,12 +349,22 @@ public:
         if (it == context_.textTranslation.end())
           continue;
         it->second.set(i.value().get<std::string>().c_str());
+        edited_ = true;
       }
     }
 
     return true;
   }
 
+  void releaseCache() noexcept {
+    xmlCache_.clear();
+    contentStyle_.reset();
+    contentDom_.reset();
+    sheetIndex_.reset();
+    if (!edited_)
+      content_.reset();
+  }
+
   bool save(const access::Path &path) const {
     // TODO throw if not decrypted
     // TODO this would decrypt/inflate and encrypt/deflate again
@@ -239,8 +387,8 @@ public:
       }
       const auto in = storage_->read(p);
       const auto out = writer.write(p);
-      if (p == "content.xml") {
-        content_.print(*out);
+      if ((p == "content.xml") && content_) {
+        content_->print(*out);
         return;
       }
       access::StreamUtil::pipe(*in, *out);
@@ -261,10 +409,90 @@ private:
   Meta::Manifest manifest_;
 
   bool decrypted_{false};
+  bool edited_{false};
 
   Context context_;
-  pugi::xml_document style_;
-  pugi::xml_document content_;
+  common::XmlCache xmlCache_;
+  std::shared_ptr<pugi::xml_document> content_;
+  std::unique_ptr<common::StyleSheet> contentStyle_;
+  // see `Config::tokenDom`
+  std::unique_ptr<common::TokenDom> contentDom_;
+
+  struct SheetIndex {
+    std::vector<StreamTranslator::SheetRange> sheets;
+    // only for zip storages
+    std::unique_ptr<access::ZipReader::Checkpoints> checkpoints;
+  };
+  std::unique_ptr<SheetIndex> sheetIndex_;
+
+  void buildSheetIndex_() {
+    auto index = std::make_unique<SheetIndex>();
+    std::unique_ptr<std::istream> in;
+    const auto zip = dynamic_cast<const access::ZipReader *>(storage_.get());
+    if (zip != nullptr) {
+      index->checkpoints = std::make_unique<access::ZipReader::Checkpoints>();
+      in = zip->read("content.xml", *index->checkpoints);
+    } else {
+      in = storage_->read("content.xml");
+    }
+    if (!in)
+      throw access::FileNotFoundException("content.xml");
+    common::XmlPullParser parser(*in);
+    index->sheets = StreamTranslator::indexSheets(parser);
+
+    if (index->checkpoints) {
+      std::vector<std::uint64_t> offsets;
+      for (auto &&sheet : index->sheets) {
+        offsets.push_back(sheet.begin);
+        for (auto &&mark : sheet.rows.marks()) {
+          offsets.push_back(mark.offset);
+        }
+      }
+      index->checkpoints->retain(offsets);
+    }
+    sheetIndex_ = std::move(index);
+  }
+
+  std::unique_ptr<std::istream> readContent_(const std::uint64_t offset) const {
+    if (sheetIndex_->checkpoints) {
+      const auto &zip = dynamic_cast<const access::ZipReader &>(*storage_);
+      return zip.read("content.xml", *sheetIndex_->checkpoints, offset);
+    }
+    auto result = storage_->read("content.xml");
+    if (result && !result->seekg(offset)) {
+      result = storage_->read("content.xml");
+      result->ignore(offset);
+    }
+    return result;
+  }
+
+  void translateSheets_(const Config &config) {
+    const std::uint32_t count = sheetIndex_->sheets.size();
+    std::uint32_t end = count;
+    if (config.entryCount > 0)
+      end = std::min(count, config.entryOffset + config.entryCount);
+    for (std::uint32_t i = config.entryOffset; i < end; ++i) {
+      const auto &sheet = sheetIndex_->sheets[i];
+      auto in = readContent_(sheet.begin);
+      if (!in)
+        throw access::FileNotFoundException("content.xml");
+      // for a window of rows the table head is followed by the rows from the
+      // closest mark on; the rows in between are never read
+      std::uint32_t skippedRows = 0;
+      if (!sheet.rows.empty()) {
+        const auto &mark = sheet.rows.find(config.tableOffsetRows);
+        if (mark.row > 0) {
+          std::string head(sheet.rows.begin() - sheet.begin, '\0');
+          in->read(head.data(), head.size());
+          in = access::StreamUtil::prepend(std::move(head),
+                                           readContent_(mark.offset));
+          skippedRows = mark.row;
+        }
+      }
+      common::XmlPullParser parser(*in);
+      StreamTranslator::sheet(parser, i, skippedRows, context_);
+    }
+  }
 };
 
 OpenDocument::OpenDocument(const char *path)
@@ -282,6 +510,11 @@ OpenDocument::OpenDocument(std::unique_ptr<access::ReadStorage> &&storage)
 OpenDocument::OpenDocument(std::unique_ptr<access::ReadStorage> &storage)
     : impl_(std::make_unique<Impl>(storage)) {}
 
+OpenDocument::OpenDocument(std::unique_ptr<access::ReadStorage> &&storage,
+                           FileMeta meta, const bool decrypted)
+    : impl_(std::make_unique<Impl>(std::move(storage), std::move(meta),
+                                   decrypted)) {}
+
 OpenDocument::OpenDocument(OpenDocument &&) noexcept = default;
 
 OpenDocument &OpenDocument::operator=(OpenDocument &&) noexcept = default;
@@ -316,6 +549,8 @@ void OpenDocument::translate(const access::Path &path, const Config &config) {
 
 void OpenDocument::edit(const std::string &diff) { impl_->edit(diff); }
 
+void OpenDocument::releaseCache() noexcept { impl_->releaseCache(); }
+
 void OpenDocument::save(const access::Path &path) const { impl_->save(path); }
 
 void OpenDocument::save(const access::Path &path,
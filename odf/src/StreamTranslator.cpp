@@ -0,0 +1,341 @@
+#include <ContentTranslator.h>
+#include <Context.h>
+#include <Meta.h>
+#include <StreamTranslator.h>
+#include <common/XmlPullParser.h>
+#include <common/XmlUtil.h>
+#include <cstdlib>
+#include <odr/Config.h>
+#include <odr/Meta.h>
+#include <pugixml.hpp>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+
+namespace odr::odf {
+
+namespace {
+using Event = common::XmlPullParser::Event;
+
+// elements without output of their own (apart from tables) which are read
+// child by child instead of being copied as a whole
+const std::unordered_set<std::string> containers{
+    "office:body",
+    "office:text",
+    "office:spreadsheet",
+    "office:presentation",
+    "office:drawing",
+    "text:section",
+    "table:table",
+    "table:table-header-columns",
+    "table:table-columns",
+    "table:table-column-group",
+    "table:table-header-rows",
+    "table:table-rows",
+    "table:table-row-group",
+};
+
+// direct children of a table which hold rows
+const std::unordered_set<std::string> rowElements{
+    "table:table-header-rows",
+    "table:table-rows",
+    "table:table-row-group",
+    "table:table-row",
+};
+
+std::uint32_t repeatedRows(const common::XmlPullParser &parser) {
+  const char *repeated = parser.attribute("table:number-rows-repeated");
+  if (repeated == nullptr)
+    return 1;
+  return std::strtoul(repeated, nullptr, 10);
+}
+
+// consumes the current row element and returns the number of rows in it
+std::uint32_t countRows(common::XmlPullParser &parser) {
+  if (parser.name() == "table:table-row") {
+    const std::uint32_t result = repeatedRows(parser);
+    parser.skip();
+    return result;
+  }
+  std::uint32_t result = 0;
+  while (true) {
+    switch (parser.next()) {
+    case Event::START_ELEMENT:
+      if (rowElements.find(parser.name()) != rowElements.end())
+        result += countRows(parser);
+      else
+        parser.skip();
+      break;
+    case Event::END_ELEMENT:
+      return result;
+    case Event::END_DOCUMENT:
+      throw common::NotXmlException();
+    default:
+      break;
+    }
+  }
+}
+
+// top level tables are at `office:document-content/office:body/
+// office:spreadsheet/table:table`
+constexpr std::uint32_t sheetDepth = 4;
+
+class Translator final {
+public:
+  Translator(common::XmlPullParser &parser, Context &context,
+             const std::uint32_t skippedRows = 0)
+      : parser_{parser}, context_{context}, skippedRows_{skippedRows} {}
+
+  // each of them returns false if reading can stop
+
+  // translates the current start element
+  bool element() {
+    const std::string name = parser_.name();
+    if (containers.find(name) == containers.end()) {
+      pugi::xml_document fragment;
+      ContentTranslator::html(parser_.copy(fragment), context_);
+      return true;
+    }
+    if (name != "table:table")
+      return children();
+
+    const bool sheet = parser_.depth() == sheetDepth;
+    pugi::xml_document fragment;
+    ContentTranslator::tableBegin(parser_.append(fragment), context_);
+    const bool proceed = children();
+    ContentTranslator::tableEnd(context_);
+    // nothing follows the last sheet which would produce output
+    if (sheet && (context_.meta->type == FileType::OPENDOCUMENT_SPREADSHEET) &&
+        (context_.entry >= context_.meta->entries.size()))
+      return false;
+    return proceed;
+  }
+
+  // translates the children of the current start element
+  bool children() {
+    while (true) {
+      switch (parser_.next()) {
+      case Event::START_ELEMENT:
+        // the first rows after the head follow the skipped ones
+        if ((skippedRows_ > 0) &&
+            (rowElements.find(parser_.name()) != rowElements.end())) {
+          context_.tableCursor.addRow(skippedRows_);
+          skippedRows_ = 0;
+        }
+        // rows outside of the table range produce no output, see
+        // `TableRowTranslator`
+        if ((parser_.name() == "table:table-row") &&
+            (context_.tableCursor.row() >= context_.tableRange.to().row())) {
+          parser_.skip();
+        } else if ((parser_.name() == "table:table-row") &&
+                   (context_.tableCursor.row() + repeatedRows(parser_) <=
+                    context_.tableRange.from().row())) {
+          context_.tableCursor.addRow(repeatedRows(parser_));
+          parser_.skip();
+        } else if (!element()) {
+          return false;
+        }
+        break;
+      case Event::TEXT: {
+        pugi::xml_document fragment;
+        fragment.append_child(pugi::node_pcdata)
+            .set_value(parser_.text().c_str());
+        ContentTranslator::children(fragment, context_);
+      } break;
+      case Event::CDATA:
+        break;
+      case Event::END_ELEMENT:
+        return true;
+      case Event::END_DOCUMENT:
+        throw common::NotXmlException();
+      }
+    }
+  }
+
+  // translates the selected entries of the current start element; everything
+  // else is skipped
+  bool entries(const std::string &entryName) {
+    const std::uint32_t offset = context_.config->entryOffset;
+    const std::uint32_t count = context_.config->entryCount;
+    std::uint32_t i = 0;
+    while (true) {
+      switch (parser_.next()) {
+      case Event::START_ELEMENT:
+        if (parser_.name() != entryName) {
+          parser_.skip();
+          break;
+        }
+        if ((i >= offset) && ((count == 0) || (i < offset + count))) {
+          if (!element())
+            return false;
+        } else {
+          ++context_.entry; // TODO hacky
+          parser_.skip();
+        }
+        ++i;
+        if ((count > 0) && (i >= offset + count))
+          return false;
+        break;
+      case Event::END_ELEMENT:
+        return true;
+      case Event::END_DOCUMENT:
+        throw common::NotXmlException();
+      default:
+        break;
+      }
+    }
+  }
+
+private:
+  common::XmlPullParser &parser_;
+  Context &context_;
+  std::uint32_t skippedRows_;
+};
+} // namespace
+
+pugi::xml_document StreamTranslator::head(common::XmlPullParser &parser) {
+  pugi::xml_document result;
+  pugi::xml_node root;
+  while (true) {
+    switch (parser.next()) {
+    case Event::START_ELEMENT:
+      if (parser.depth() == 1) {
+        root = parser.append(result);
+      } else if (parser.name() == "office:body") {
+        return result;
+      } else {
+        parser.copy(root);
+      }
+      break;
+    case Event::END_DOCUMENT:
+      throw NoOpenDocumentFileException();
+    default:
+      break;
+    }
+  }
+}
+
+void StreamTranslator::html(common::XmlPullParser &parser, Context &context) {
+  std::string contentName;
+  std::string entryName;
+  switch (context.meta->type) {
+  case FileType::OPENDOCUMENT_TEXT:
+  case FileType::OPENDOCUMENT_GRAPHICS:
+    contentName = "office:drawing";
+    entryName = "draw:page";
+    break;
+  case FileType::OPENDOCUMENT_PRESENTATION:
+    contentName = "office:presentation";
+    entryName = "draw:page";
+    break;
+  case FileType::OPENDOCUMENT_SPREADSHEET:
+    contentName = "office:spreadsheet";
+    entryName = "table:table";
+    break;
+  default:
+    throw std::invalid_argument("type");
+  }
+
+  context.entry = 0;
+
+  Translator translator(parser, context);
+  if ((context.config->entryOffset == 0) && (context.config->entryCount == 0)) {
+    translator.element();
+    return;
+  }
+
+  // like `generateContent_`: only the entries of the content element are
+  // translated if there is one, otherwise the whole body
+  while (true) {
+    switch (parser.next()) {
+    case Event::START_ELEMENT:
+      if (parser.name() == contentName) {
+        translator.entries(entryName);
+        return;
+      }
+      if (!translator.element())
+        return;
+      break;
+    case Event::TEXT: {
+      pugi::xml_document fragment;
+      fragment.append_child(pugi::node_pcdata)
+          .set_value(parser.text().c_str());
+      ContentTranslator::children(fragment, context);
+    } break;
+    case Event::END_ELEMENT:
+    case Event::END_DOCUMENT:
+      return;
+    default:
+      break;
+    }
+  }
+}
+
+namespace {
+// consumes the current table and adds its rows to `index`
+void indexRows(common::XmlPullParser &parser, common::TableRowIndex &index) {
+  std::uint32_t row = 0;
+  while (true) {
+    switch (parser.next()) {
+    case Event::START_ELEMENT:
+      if (rowElements.find(parser.name()) != rowElements.end()) {
+        index.add(row, parser.offset());
+        row += countRows(parser);
+      } else {
+        parser.skip();
+      }
+      break;
+    case Event::END_ELEMENT:
+      return;
+    case Event::END_DOCUMENT:
+      throw common::NotXmlException();
+    default:
+      break;
+    }
+  }
+}
+} // namespace
+
+std::vector<StreamTranslator::SheetRange>
+StreamTranslator::indexSheets(common::XmlPullParser &parser) {
+  static const std::unordered_set<std::string> path{
+      "office:document-content",
+      "office:body",
+      "office:spreadsheet",
+  };
+
+  std::vector<SheetRange> result;
+  while (true) {
+    switch (parser.next()) {
+    case Event::START_ELEMENT:
+      if ((parser.depth() == sheetDepth) &&
+          (parser.name() == "table:table")) {
+        result.push_back({parser.offset(), 0, common::TableRowIndex()});
+        indexRows(parser, result.back().rows);
+        result.back().end = parser.endOffset();
+      } else if (parser.depth() == sheetDepth) {
+        parser.skip();
+      } else if (path.find(parser.name()) == path.end()) {
+        parser.skip();
+      }
+      break;
+    case Event::END_DOCUMENT:
+      return result;
+    default:
+      break;
+    }
+  }
+}
+
+void StreamTranslator::sheet(common::XmlPullParser &parser,
+                             const std::uint32_t entry,
+                             const std::uint32_t skippedRows,
+                             Context &context) {
+  if ((parser.next() != Event::START_ELEMENT) ||
+      (parser.name() != "table:table"))
+    throw common::NotXmlException();
+  context.entry = entry;
+  Translator(parser, context, skippedRows).element();
+}
+
+} // namespace odr::odf
@@ -0,0 +1,48 @@
+#ifndef ODR_ODF_STREAM_TRANSLATOR_H
+#define ODR_ODF_STREAM_TRANSLATOR_H
+
+#include <common/TableRowIndex.h>
+#include <cstdint>
+#include <vector>
+
+namespace pugi {
+class xml_document;
+}
+
+namespace odr::common {
+class XmlPullParser;
+}
+
+namespace odr::odf {
+
+struct Context;
+
+// translates `content.xml` while reading it. only the current paragraph, row,
+// page etc. is parsed into a DOM and handed to `ContentTranslator`, so memory
+// stays bounded and output starts right away.
+namespace StreamTranslator {
+// reads up to the start of `office:body` and returns everything before it,
+// i.e. font faces and automatic styles
+pugi::xml_document head(common::XmlPullParser &parser);
+// translates `office:body`; stops reading once the rest cannot produce output
+void html(common::XmlPullParser &parser, Context &context);
+
+// decompressed byte range of a sheet within `content.xml`
+struct SheetRange {
+  std::uint64_t begin;
+  std::uint64_t end;
+  // rows and row groups which are direct children of the table
+  common::TableRowIndex rows;
+};
+
+// scans a whole spreadsheet `content.xml` without building any DOM
+std::vector<SheetRange> indexSheets(common::XmlPullParser &parser);
+// translates the sheet at `entry` from a parser reading its range. if the
+// reader jumped from the table head to a row mark, `skippedRows` is its row.
+void sheet(common::XmlPullParser &parser, std::uint32_t entry,
+           std::uint32_t skippedRows, Context &context);
+} // namespace StreamTranslator
+
+} // namespace odr::odf
+
+#endif // ODR_ODF_STREAM_TRANSLATOR_H
@@ -1,57 +1,57 @@
 #include <StyleTranslator.h>
+#include <common/HtmlWriter.h>
+#include <common/NameTable.h>
 #include <common/StringUtil.h>
 #include <cstring>
 #include <glog/logging.h>
 #include <pugixml.hpp>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 
 namespace odr::odf {
 
 namespace {
+constexpr auto cssProperties = common::nameTable<const char *>({
+    {"fo:text-align", "text-align"},
+    {"fo:font-size", "font-size"},
+    {"fo:font-weight", "font-weight"},
+    {"fo:font-style", "font-style"},
+    {"fo:text-shadow", "text-shadow"},
+    {"fo:color", "color"},
+    {"fo:background-color", "background-color"},
+    {"fo:page-width", "width"},
+    {"fo:page-height", "height"},
+    {"fo:margin-top", "margin-top"},
+    {"fo:margin-right", "margin-right"},
+    {"fo:margin-bottom", "margin-bottom"},
+    {"fo:margin-left", "margin-left"},
+    {"fo:padding", "padding"},
+    {"fo:padding-top", "padding-top"},
+    {"fo:padding-right", "padding-right"},
+    {"fo:padding-bottom", "padding-bottom"},
+    {"fo:padding-left", "padding-left"},
+    {"fo:border", "border"},
+    {"fo:border-top", "border-top"},
+    {"fo:border-right", "border-right"},
+    {"fo:border-bottom", "border-bottom"},
+    {"fo:border-left", "border-left"},
+    {"style:font-name", "font-family"},
+    {"style:width", "width"},
+    {"style:height", "height"},
+    {"style:vertical-align", "vertical-align"},
+    {"style:column-width", "width"},
+    {"style:row-height", "height"},
+    {"draw:fill-color", "fill"},
+    {"svg:stroke-color", "stroke"},
+    {"svg:stroke-width", "stroke-width"},
+    {"text:display", "display"},
+});
+
 void StylePropertiesTranslator(const pugi::xml_attribute &in,
-                               std::ostream &out) {
-  static std::unordered_map<std::string, const char *> substitution{
-      {"fo:text-align", "text-align"},
-      {"fo:font-size", "font-size"},
-      {"fo:font-weight", "font-weight"},
-      {"fo:font-style", "font-style"},
-      {"fo:font-size", "font-size"},
-      {"fo:text-shadow", "text-shadow"},
-      {"fo:color", "color"},
-      {"fo:background-color", "background-color"},
-      {"fo:page-width", "width"},
-      {"fo:page-height", "height"},
-      {"fo:margin-top", "margin-top"},
-      {"fo:margin-right", "margin-right"},
-      {"fo:margin-bottom", "margin-bottom"},
-      {"fo:margin-left", "margin-left"},
-      {"fo:padding", "padding"},
-      {"fo:padding-top", "padding-top"},
-      {"fo:padding-right", "padding-right"},
-      {"fo:padding-bottom", "padding-bottom"},
-      {"fo:padding-left", "padding-left"},
-      {"fo:border", "border"},
-      {"fo:border-top", "border-top"},
-      {"fo:border-right", "border-right"},
-      {"fo:border-bottom", "border-bottom"},
-      {"fo:border-left", "border-left"},
-      {"style:font-name", "font-family"},
-      {"style:width", "width"},
-      {"style:height", "height"},
-      {"style:vertical-align", "vertical-align"},
-      {"style:column-width", "width"},
-      {"style:row-height", "height"},
-      {"draw:fill-color", "fill"},
-      {"svg:stroke-color", "stroke"},
-      {"svg:stroke-width", "stroke-width"},
-      {"text:display", "display"},
-  };
-
-  const std::string property = in.name();
-  const auto it = substitution.find(property);
-  if (it != substitution.end()) {
-    out << it->second << ":" << in.as_string() << ";";
+                               common::HtmlWriter &out) {
+  const std::string_view property = in.name();
+  if (const char *css = cssProperties.find(property, nullptr); css) {
+    out << css << ":" << in.as_string() << ";";
   } else if (property == "style:text-underline-style") {
     // TODO breaks line-through
     if (std::strcmp(in.as_string(), "solid") == 0)
@@ -66,21 +66,20 @@ void StylePropertiesTranslator(const pugi::xml_attribute &in,
   }
 }
 
-void StyleClassTranslator(const pugi::xml_node &in, std::ostream &out,
+constexpr auto elementToNameAttr = common::nameTable<const char *>({
+    {"style:default-style", "style:family"},
+    {"style:style", "style:name"},
+    {"style:page-layout", "style:name"},
+    {"style:master-page", "style:name"},
+});
+
+void StyleClassTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                           Context &context) {
-  static std::unordered_map<std::string, const char *> elementToNameAttr{
-      {"style:default-style", "style:family"},
-      {"style:style", "style:name"},
-      {"style:page-layout", "style:name"},
-      {"style:master-page", "style:name"},
-  };
-
-  const std::string element = in.name();
-  const auto it = elementToNameAttr.find(element);
-  if (it == elementToNameAttr.end())
+  const char *nameAttrName = elementToNameAttr.find(in.name(), nullptr);
+  if (nameAttrName == nullptr)
     return;
 
-  const auto nameAttr = in.attribute(it->second);
+  const auto nameAttr = in.attribute(nameAttrName);
   if (!nameAttr) {
     LOG(WARNING) << "skipped style " << in.name() << ". no name attribute.";
     return;
@@ -120,7 +119,7 @@ void StyleClassTranslator(const pugi::xml_node &in, std::ostream &out,
 }
 
 // TODO
-void ListStyleTranslator(const pugi::xml_node &in, std::ostream &,
+void ListStyleTranslator(const pugi::xml_node &in, common::HtmlWriter &,
                          Context &context) {
   // addElementDelegation("text:list-level-style-number", propertiesTranslator);
   // addElementDelegation("text:list-level-style-bullet", propertiesTranslator);
@@ -0,0 +1,56 @@
+#ifndef ODR_ARENA_H
+#define ODR_ARENA_H
+
+#include <cstdint>
+#include <memory>
+
+namespace odr {
+
+namespace common {
+class XmlArena;
+}
+
+// per worker memory for parsed document parts. open, translate and close
+// documents inside a `Scope`, then `reset` the arena to reuse its memory for
+// the next request. documents (and their caches) have to be gone before the
+// reset; otherwise it throws.
+//
+// the first arena or parsed document replaces the process-wide pugixml memory
+// functions, which affects a host application using the same pugixml. blocks
+// allocated before are freed with the previous functions.
+class Arena final {
+public:
+  struct Stats {
+    std::uint64_t used;
+    std::uint64_t peak;
+    std::uint64_t reserved;
+    std::uint64_t reused;
+  };
+
+  class Scope final {
+  public:
+    explicit Scope(const Arena &arena);
+    Scope(const Scope &) = delete;
+    ~Scope();
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+  };
+
+  explicit Arena(std::uint64_t blockSize = 1024 * 1024);
+  Arena(const Arena &) = delete;
+  ~Arena();
+  Arena &operator=(const Arena &) = delete;
+
+  void reset() const;
+  Stats stats() const noexcept;
+
+private:
+  std::unique_ptr<common::XmlArena> impl_;
+};
+
+} // namespace odr
+
+#endif // ODR_ARENA_H
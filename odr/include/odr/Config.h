@@ -2,6 +2,7 @@
 #define ODR_CONFIG_H
 
 #include <cstdint>
+#include <string>
 
 namespace odr {
 
@@ -11,6 +12,7 @@ enum class TableGridlines {
   HARD,
 };
 
+// keep `TranslationCache::configKey` in sync when adding fields
 struct Config {
   // starting sheet for spreadsheet, starting page for presentation, ignored for
   // text, ignored for graphics
@@ -31,6 +33,38 @@ struct Config {
   bool tableLimitByDimensions{true};
   // spreadsheet gridlines
   TableGridlines tableGridlines{TableGridlines::SOFT};
+
+  // emit only the css of styles used by the translated content; shrinks the
+  // output when `entryOffset` and `entryCount` select a part of a document
+  // with many styles. the body is held in memory until the styles are
+  // known, so `streaming` no longer bounds the memory of the output. for
+  // OpenDocument and workbooks, ignored otherwise
+  bool pruneStyles{false};
+  // merge every style with its dependencies into one generated class and
+  // share the classes of styles with equal declarations; shortens the css and
+  // the class lists of documents with many automatic styles. for OpenDocument
+  // and workbooks, ignored otherwise
+  bool flattenStyles{false};
+
+  // directory to write images and media to instead of inlining them; the
+  // html references them relative to its own path and loads them lazily.
+  // empty inlines them. translations with resources bypass the
+  // `TranslationCache`
+  std::string resourcePath;
+
+  // translate the content while reading it instead of parsing it as a whole
+  // first; bounds memory and lowers latency for huge documents unless
+  // `pruneStyles` is set. ignored for editable output. does not influence the
+  // output
+  bool streaming{false};
+  // translate from a compact read-only tree instead of pugixml; lowers memory
+  // and parse time. only used for OpenDocument content, ignored for streaming
+  // and editable output. does not influence the output
+  bool tokenDom{false};
+
+  // memory limit for parsed parts kept between translations; zero disables
+  // caching. does not influence the output
+  std::uint64_t xmlCacheLimit{128 * 1024 * 1024};
 };
 
 } // namespace odr
@@ -14,6 +14,7 @@ class Document;
 enum class FileType;
 struct FileMeta;
 struct Config;
+class TranslationCache;
 
 class Document final {
 public:
@@ -22,6 +23,10 @@ public:
 
   static FileType type(const std::string &path);
   static FileMeta meta(const std::string &path);
+  // stable 128 bit identity of the file; safe to use as a cache key. ZIP
+  // files are identified by their central directory without inflating
+  // anything, CFB files by a hash of their full content
+  static std::string fingerprint(const std::string &path);
 
   explicit Document(const std::string &path);
   Document(const std::string &path, FileType as);
@@ -34,6 +39,7 @@ public:
   FileType type() const noexcept;
   bool encrypted() const noexcept;
   const FileMeta &meta() const noexcept;
+  std::string fingerprint() const;
 
   bool decrypted() const noexcept;
   bool translatable() const noexcept;
@@ -43,12 +49,30 @@ public:
   bool decrypt(const std::string &password) const;
 
   void translate(const std::string &path, const Config &config) const;
+  // serves the output from `cache` if possible; editable translations,
+  // encrypted documents and translations with `Config::resourcePath` bypass
+  // the cache
+  void translate(const std::string &path, const Config &config,
+                 const TranslationCache &cache) const;
   void edit(const std::string &diff) const;
 
+  // drops parsed parts kept between translations; see `Config::xmlCacheLimit`
+  void releaseCache() const noexcept;
+
+  // writes the inflated parts together with the meta into a file which can
+  // be opened like the original document. compare `fingerprint()` with the
+  // one of the original to detect stale snapshots. only inflating and meta
+  // detection are saved; the parts are parsed again on translate. throws
+  // `UnsupportedOperation` for encrypted documents, so that no plaintext is
+  // written to disk
+  void snapshot(const std::string &path) const;
+
   void save(const std::string &path) const;
   void save(const std::string &path, const std::string &password) const;
 
 private:
+  std::string path_;
+  mutable std::string fingerprint_;
   std::unique_ptr<common::Document> impl_;
 };
 
@@ -60,12 +84,14 @@ public:
 
   static FileType type(const std::string &path) noexcept;
   static FileMeta meta(const std::string &path) noexcept;
+  static std::string fingerprint(const std::string &path) noexcept;
 
   explicit DocumentNoExcept(std::unique_ptr<Document>);
 
   FileType type() const noexcept;
   bool encrypted() const noexcept;
   const FileMeta &meta() const noexcept;
+  std::string fingerprint() const noexcept;
 
   bool decrypted() const noexcept;
   bool canTranslate() const noexcept;
@@ -76,7 +102,11 @@ public:
   bool decrypt(const std::string &password) const noexcept;
 
   bool translate(const std::string &path, const Config &config) const noexcept;
+  bool translate(const std::string &path, const Config &config,
+                 const TranslationCache &cache) const noexcept;
   bool edit(const std::string &diff) const noexcept;
+  void releaseCache() const noexcept;
+  bool snapshot(const std::string &path) const noexcept;
 
   bool save(const std::string &path) const noexcept;
   bool save(const std::string &path,
@@ -0,0 +1,51 @@
+#ifndef ODR_TRANSLATION_CACHE_H
+#define ODR_TRANSLATION_CACHE_H
+
+#include <cstdint>
+#include <string>
+
+namespace odr {
+
+struct Config;
+
+// on-disk cache of translated outputs keyed by input and config fingerprints.
+// entries are published atomically (temp file + rename) so that several
+// processes may share one directory. the oldest entries are evicted once the
+// total size exceeds `maxSize`.
+class TranslationCache final {
+public:
+  // `Document::fingerprint` for documents, content hash otherwise
+  static std::string inputKey(const std::string &path);
+  static std::string configKey(const Config &config);
+
+  TranslationCache(std::string directory, std::uint64_t maxSize);
+
+  const std::string &directory() const noexcept;
+  std::uint64_t maxSize() const noexcept;
+  // total size of all cached outputs in bytes
+  std::uint64_t size() const;
+
+  // copies the cached output to `outputPath` if present
+  bool lookup(const std::string &inputKey, const std::string &configKey,
+              const std::string &outputPath) const;
+  // stores a copy of `outputPath` and evicts old entries if necessary
+  void publish(const std::string &inputKey, const std::string &configKey,
+               const std::string &outputPath) const;
+
+  // removes all outputs of one input
+  void invalidate(const std::string &inputKey) const;
+  void clear() const;
+
+private:
+  std::string directory_;
+  std::uint64_t maxSize_;
+
+  std::string entryPath_(const std::string &inputKey,
+                         const std::string &configKey) const;
+  // never evicts `keep`, the entry just published
+  void evict_(const std::string &keep) const;
+};
+
+} // namespace odr
+
+#endif // ODR_TRANSLATION_CACHE_H
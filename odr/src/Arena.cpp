@@ -0,0 +1,30 @@
+#include <common/XmlArena.h>
+#include <odr/Arena.h>
+
+namespace odr {
+
+class Arena::Scope::Impl final {
+public:
+  explicit Impl(common::XmlArena &arena) : scope(arena) {}
+
+  common::XmlArena::Scope scope;
+};
+
+Arena::Scope::Scope(const Arena &arena)
+    : impl_{std::make_unique<Impl>(*arena.impl_)} {}
+
+Arena::Scope::~Scope() = default;
+
+Arena::Arena(const std::uint64_t blockSize)
+    : impl_{std::make_unique<common::XmlArena>(blockSize)} {}
+
+Arena::~Arena() = default;
+
+void Arena::reset() const { impl_->reset(); }
+
+Arena::Stats Arena::stats() const noexcept {
+  const auto stats = impl_->stats();
+  return {stats.used, stats.peak, stats.reserved, stats.reused};
+}
+
+} // namespace odr
@@ -1,5 +1,6 @@
 #include <access/CfbStorage.h>
 #include <access/Path.h>
+#include <access/SnapshotStorage.h>
 #include <access/Storage.h>
 #include <access/ZipStorage.h>
 #include <common/Constants.h>
@@ -11,6 +12,7 @@
 #include <odr/Document.h>
 #include <odr/Exception.h>
 #include <odr/Meta.h>
+#include <odr/TranslationCache.h>
 #include <oldms/LegacyMicrosoft.h>
 #include <ooxml/OfficeOpenXml.h>
 #include <utility>
@@ -18,7 +20,119 @@
 namespace odr {
 
 namespace {
+struct SnapshotHeader {
+  std::string fingerprint;
+  bool decrypted{false};
+  FileMeta meta;
+};
+
+void appendInt(std::string &out, std::uint32_t value) {
+  for (int i = 0; i < 4; ++i, value >>= 8) {
+    out += static_cast<char>(value & 0xff);
+  }
+}
+
+void appendString(std::string &out, const std::string &value) {
+  appendInt(out, value.size());
+  out += value;
+}
+
+std::uint32_t readInt(const std::string &in, std::size_t &offset) {
+  if (in.size() - offset < 4)
+    throw access::SnapshotCorruptedException();
+  std::uint32_t result = 0;
+  for (int i = 0; i < 4; ++i) {
+    result |= std::uint32_t(static_cast<unsigned char>(in[offset++]))
+              << (8 * i);
+  }
+  return result;
+}
+
+std::string readString(const std::string &in, std::size_t &offset) {
+  const std::uint32_t size = readInt(in, offset);
+  if (in.size() - offset < size)
+    throw access::SnapshotCorruptedException();
+  std::string result = in.substr(offset, size);
+  offset += size;
+  return result;
+}
+
+std::string serializeSnapshotHeader(const SnapshotHeader &header) {
+  std::string result;
+  appendString(result, header.fingerprint);
+  appendInt(result, header.decrypted);
+  appendInt(result, static_cast<std::uint32_t>(header.meta.type));
+  appendInt(result, header.meta.confident);
+  appendInt(result, header.meta.encrypted);
+  appendInt(result, header.meta.entryCount);
+  appendInt(result, header.meta.entries.size());
+  for (auto &&e : header.meta.entries) {
+    appendString(result, e.name);
+    appendInt(result, e.rowCount);
+    appendInt(result, e.columnCount);
+    appendString(result, e.notes);
+  }
+  return result;
+}
+
+SnapshotHeader parseSnapshotHeader(const std::string &in) {
+  SnapshotHeader result;
+  std::size_t offset = 0;
+  result.fingerprint = readString(in, offset);
+  result.decrypted = readInt(in, offset) != 0;
+  result.meta.type = static_cast<FileType>(readInt(in, offset));
+  result.meta.confident = readInt(in, offset) != 0;
+  result.meta.encrypted = readInt(in, offset) != 0;
+  result.meta.entryCount = readInt(in, offset);
+  const std::uint32_t entries = readInt(in, offset);
+  for (std::uint32_t i = 0; i < entries; ++i) {
+    FileMeta::Entry entry;
+    entry.name = readString(in, offset);
+    entry.rowCount = readInt(in, offset);
+    entry.columnCount = readInt(in, offset);
+    entry.notes = readString(in, offset);
+    result.meta.entries.push_back(std::move(entry));
+  }
+  return result;
+}
+
+std::unique_ptr<common::Document> openSnapshot(const std::string &path) {
+  auto storage = std::make_unique<access::SnapshotReader>(path);
+  SnapshotHeader header = parseSnapshotHeader(storage->header());
+
+  switch (header.meta.type) {
+  case FileType::OPENDOCUMENT_TEXT:
+  case FileType::OPENDOCUMENT_PRESENTATION:
+  case FileType::OPENDOCUMENT_SPREADSHEET:
+  case FileType::OPENDOCUMENT_GRAPHICS:
+    return std::make_unique<odf::OpenDocument>(
+        std::move(storage), std::move(header.meta), header.decrypted);
+  case FileType::OFFICE_OPEN_XML_DOCUMENT:
+  case FileType::OFFICE_OPEN_XML_PRESENTATION:
+  case FileType::OFFICE_OPEN_XML_WORKBOOK:
+  case FileType::OFFICE_OPEN_XML_ENCRYPTED:
+    return std::make_unique<ooxml::OfficeOpenXml>(
+        std::move(storage), std::move(header.meta), header.decrypted);
+  default:
+    throw UnknownFileType();
+  }
+}
+
+const access::ReadStorage &storageOf(const common::Document &document) {
+  if (const auto odf = dynamic_cast<const odf::OpenDocument *>(&document))
+    return odf->storage();
+  if (const auto ooxml = dynamic_cast<const ooxml::OfficeOpenXml *>(&document))
+    return ooxml->storage();
+  throw UnsupportedOperation();
+}
+
 std::unique_ptr<common::Document> openImpl(const std::string &path) {
+  try {
+    return openSnapshot(path);
+  } catch (access::NoSnapshotFileException &) {
+  } catch (access::FileNotFoundException &) {
+  }
+
   try {
     std::unique_ptr<access::ReadStorage> storage =
         std::make_unique<access::ZipReader>(path);
@@ -84,10 +198,33 @@ FileMeta Document::meta(const std::string &path) {
   return document->meta();
 }
 
-Document::Document(const std::string &path) : impl_(openImpl(path)) {}
+std::string Document::fingerprint(const std::string &path) {
+  try {
+    // identity of the document the snapshot was taken from
+    return parseSnapshotHeader(access::SnapshotReader(path).header())
+        .fingerprint;
+  } catch (access::NoSnapshotFileException &) {
+  } catch (access::FileNotFoundException &) {
+  }
+  try {
+    return access::ZipReader(path).fingerprint();
+  } catch (...) {
+    // TODO
+  }
+  try {
+    return access::CfbReader(path).fingerprint();
+  } catch (...) {
+    // TODO
+  }
+
+  throw UnknownFileType();
+}
+
+Document::Document(const std::string &path)
+    : path_{path}, impl_(openImpl(path)) {}
 
 Document::Document(const std::string &path, const FileType as)
-    : impl_(openImpl(path, as)) {}
+    : path_{path}, impl_(openImpl(path, as)) {}
 
 Document::Document(Document &&) noexcept = default;
 
@@ -101,6 +238,13 @@ bool Document::encrypted() const noexcept { return impl_->meta().encrypted; }
 
 const FileMeta &Document::meta() const noexcept { return impl_->meta(); }
 
+std::string Document::fingerprint() const {
+  if (fingerprint_.empty()) {
+    fingerprint_ = fingerprint(path_);
+  }
+  return fingerprint_;
+}
+
 bool Document::decrypted() const noexcept { return impl_->decrypted(); }
 
 bool Document::translatable() const noexcept { return impl_->translatable(); }
@@ -119,8 +263,40 @@ void Document::translate(const std::string &path, const Config &config) const {
   impl_->translate(path, config);
 }
 
+void Document::translate(const std::string &path, const Config &config,
+                         const TranslationCache &cache) const {
+  // editing relies on the state collected during translation; the output of
+  // encrypted documents must not outlive the session in a shared directory;
+  // the side files of `resourcePath` are not part of the cached output
+  if (config.editable || encrypted() || !config.resourcePath.empty()) {
+    translate(path, config);
+    return;
+  }
+
+  const std::string inputKey = fingerprint();
+  const std::string configKey = TranslationCache::configKey(config);
+  if (cache.lookup(inputKey, configKey, path)) {
+    return;
+  }
+  translate(path, config);
+  cache.publish(inputKey, configKey, path);
+}
+
 void Document::edit(const std::string &diff) const { impl_->edit(diff); }
 
+void Document::snapshot(const std::string &path) const {
+  if (encrypted())
+    throw UnsupportedOperation();
+  SnapshotHeader header;
+  header.fingerprint = fingerprint();
+  header.decrypted = decrypted();
+  header.meta = meta();
+  access::SnapshotReader::write(path, storageOf(*impl_),
+                                serializeSnapshotHeader(header));
+}
+
+void Document::releaseCache() const noexcept { impl_->releaseCache(); }
+
 void Document::save(const std::string &path) const { impl_->save(path); }
 
 void Document::save(const std::string &path,
@@ -168,6 +344,15 @@ FileMeta DocumentNoExcept::meta(const std::string &path) noexcept {
   }
 }
 
+std::string DocumentNoExcept::fingerprint(const std::string &path) noexcept {
+  try {
+    return Document::fingerprint(path);
+  } catch (...) {
+    LOG(ERROR) << "fingerprint failed";
+    return "";
+  }
+}
+
 DocumentNoExcept::DocumentNoExcept(std::unique_ptr<Document> impl)
     : impl_{std::move(impl)} {}
 
@@ -198,6 +383,15 @@ const FileMeta &DocumentNoExcept::meta() const noexcept {
   }
 }
 
+std::string DocumentNoExcept::fingerprint() const noexcept {
+  try {
+    return impl_->fingerprint();
+  } catch (...) {
+    LOG(ERROR) << "fingerprint failed";
+    return "";
+  }
+}
+
 bool DocumentNoExcept::decrypted() const noexcept {
   try {
     return impl_->decrypted();
@@ -256,6 +450,17 @@ bool DocumentNoExcept::translate(const std::string &path,
   }
 }
 
+bool DocumentNoExcept::translate(const std::string &path, const Config &config,
+                                 const TranslationCache &cache) const noexcept {
+  try {
+    impl_->translate(path, config, cache);
+    return true;
+  } catch (...) {
+    LOG(ERROR) << "translate failed";
+    return false;
+  }
+}
+
 bool DocumentNoExcept::edit(const std::string &diff) const noexcept {
   try {
     impl_->edit(diff);
@@ -266,6 +471,18 @@ bool DocumentNoExcept::edit(const std::string &diff) const noexcept {
   }
 }
 
+void DocumentNoExcept::releaseCache() const noexcept { impl_->releaseCache(); }
+
+bool DocumentNoExcept::snapshot(const std::string &path) const noexcept {
+  try {
+    impl_->snapshot(path);
+    return true;
+  } catch (...) {
+    LOG(ERROR) << "snapshot failed";
+    return false;
+  }
+}
+
 bool DocumentNoExcept::save(const std::string &path) const noexcept {
   try {
     impl_->save(path);
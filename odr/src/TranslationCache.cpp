@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <crypto/CryptoUtil.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <glog/logging.h>
+#include <odr/Config.h>
+#include <odr/Document.h>
+#include <odr/Exception.h>
+#include <odr/TranslationCache.h>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace odr {
+
+namespace {
+// bump if the output of the translators changes for the same input and config
+constexpr std::uint32_t keyVersion = 4;
+constexpr const char *entryExtension = ".html";
+constexpr const char *tempPrefix = ".tmp-";
+
+void append(std::string &out, const std::uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    out += static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+}
+
+std::string randomSuffix() {
+  static thread_local std::mt19937_64 generator{std::random_device{}()};
+  std::string bytes(8, '\0');
+  const std::uint64_t value = generator();
+  std::memcpy(bytes.data(), &value, sizeof(value));
+  return crypto::Util::hexEncode(bytes);
+}
+
+bool isEntry(const fs::directory_entry &entry) {
+  const std::string name = entry.path().filename().string();
+  return entry.is_regular_file() && name.rfind(tempPrefix, 0) != 0 &&
+         entry.path().extension() == entryExtension;
+}
+} // namespace
+
+std::string TranslationCache::inputKey(const std::string &path) {
+  try {
+    return Document::fingerprint(path);
+  } catch (...) {
+    // not a container; fall back to hashing the content
+  }
+
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open() || in.fail()) {
+    throw FileNotFound(std::strerror(errno));
+  }
+  // 128 bit are plenty to identify a document
+  return crypto::Util::hexEncode(crypto::Util::sha256(in).substr(0, 16));
+}
+
+std::string TranslationCache::configKey(const Config &config) {
+  // every field influencing the output has to be serialized here in a fixed
+  // order
+  std::string serialized;
+  append(serialized, keyVersion);
+  append(serialized, config.entryOffset);
+  append(serialized, config.entryCount);
+  append(serialized, config.splitEntries);
+  append(serialized, config.editable);
+  append(serialized, config.tableOffsetRows);
+  append(serialized, config.tableOffsetCols);
+  append(serialized, config.tableLimitRows);
+  append(serialized, config.tableLimitCols);
+  append(serialized, config.tableLimitByDimensions);
+  append(serialized, static_cast<std::uint32_t>(config.tableGridlines));
+  append(serialized, config.pruneStyles);
+  append(serialized, config.flattenStyles);
+  // `streaming`, `tokenDom` and `xmlCacheLimit` do not influence the output.
+  // outputs with `resourcePath` are not cached
+  return crypto::Util::hexEncode(
+      crypto::Util::sha256(serialized).substr(0, 16));
+}
+
+TranslationCache::TranslationCache(std::string directory,
+                                   const std::uint64_t maxSize)
+    : directory_{std::move(directory)}, maxSize_{maxSize} {
+  fs::create_directories(directory_);
+}
+
+const std::string &TranslationCache::directory() const noexcept {
+  return directory_;
+}
+
+std::uint64_t TranslationCache::maxSize() const noexcept { return maxSize_; }
+
+std::uint64_t TranslationCache::size() const {
+  std::uint64_t result = 0;
+  std::error_code ec;
+  for (auto &&entry : fs::directory_iterator(directory_, ec)) {
+    if (isEntry(entry)) {
+      result += entry.file_size(ec);
+    }
+  }
+  return result;
+}
+
+bool TranslationCache::lookup(const std::string &inputKey,
+                              const std::string &configKey,
+                              const std::string &outputPath) const {
+  const std::string entryPath = entryPath_(inputKey, configKey);
+  std::error_code ec;
+  // copy_file uses sendfile / copy_file_range where available
+  fs::copy_file(entryPath, outputPath, fs::copy_options::overwrite_existing,
+                ec);
+  if (ec) {
+    return false;
+  }
+  // refresh for least recently used eviction
+  fs::last_write_time(entryPath, fs::file_time_type::clock::now(), ec);
+  return true;
+}
+
+void TranslationCache::publish(const std::string &inputKey,
+                               const std::string &configKey,
+                               const std::string &outputPath) const {
+  const fs::path tempPath =
+      fs::path(directory_) / (tempPrefix + inputKey + "-" + randomSuffix());
+  std::error_code ec;
+  fs::copy_file(outputPath, tempPath, ec);
+  if (!ec) {
+    // rename is atomic within one file system; readers never see partial files
+    fs::rename(tempPath, entryPath_(inputKey, configKey), ec);
+  }
+  if (ec) {
+    LOG(WARNING) << "cache publish failed: " << ec.message();
+    fs::remove(tempPath, ec);
+    return;
+  }
+  evict_(entryPath_(inputKey, configKey));
+}
+
+void TranslationCache::invalidate(const std::string &inputKey) const {
+  const std::string prefix = inputKey + "-";
+  std::vector<fs::path> remove;
+  std::error_code ec;
+  for (auto &&entry : fs::directory_iterator(directory_, ec)) {
+    if (isEntry(entry) &&
+        entry.path().filename().string().rfind(prefix, 0) == 0) {
+      remove.push_back(entry.path());
+    }
+  }
+  for (auto &&path : remove) {
+    fs::remove(path, ec);
+  }
+}
+
+void TranslationCache::clear() const {
+  std::vector<fs::path> remove;
+  std::error_code ec;
+  for (auto &&entry : fs::directory_iterator(directory_, ec)) {
+    if (isEntry(entry)) {
+      remove.push_back(entry.path());
+    }
+  }
+  for (auto &&path : remove) {
+    fs::remove(path, ec);
+  }
+}
+
+std::string TranslationCache::entryPath_(const std::string &inputKey,
+                                         const std::string &configKey) const {
+  return (fs::path(directory_) / (inputKey + "-" + configKey + entryExtension))
+      .string();
+}
+
+void TranslationCache::evict_(const std::string &keep) const {
+  struct Entry {
+    fs::path path;
+    std::uint64_t size;
+    fs::file_time_type time;
+  };
+
+  std::vector<Entry> entries;
+  std::uint64_t total = 0;
+  std::error_code ec;
+  for (auto &&entry : fs::directory_iterator(directory_, ec)) {
+    if (!isEntry(entry)) {
+      continue;
+    }
+    const std::uint64_t size = entry.file_size(ec);
+    if (ec) {
+      continue;
+    }
+    total += size;
+    // counts, but entries with the same time may not sort before it
+    if (entry.path() != fs::path(keep)) {
+      entries.push_back({entry.path(), size, entry.last_write_time(ec)});
+    }
+  }
+  if (total <= maxSize_) {
+    return;
+  }
+
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry &a, const Entry &b) { return a.time < b.time; });
+  for (auto &&entry : entries) {
+    if (total <= maxSize_) {
+      break;
+    }
+    // other processes may have removed the entry already
+    if (fs::remove(entry.path, ec) || !ec) {
+      total -= entry.size;
+    }
+  }
+}
+
+} // namespace odr
@@ -37,6 +37,8 @@ public:
 
   void edit(const std::string &diff) final;
 
+  void releaseCache() noexcept final;
+
   void save(const access::Path &path) const final;
   void save(const access::Path &path, const std::string &password) const final;
 
@@ -87,6 +87,8 @@ void LegacyMicrosoft::edit(const std::string &) {
   throw UnsupportedOperation();
 }
 
+void LegacyMicrosoft::releaseCache() noexcept {}
+
 void LegacyMicrosoft::save(const access::Path &) const {
   throw UnsupportedOperation();
 }
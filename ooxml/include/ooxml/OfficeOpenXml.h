@@ -18,6 +18,9 @@ public:
   explicit OfficeOpenXml(const access::Path &path);
   explicit OfficeOpenXml(std::unique_ptr<access::ReadStorage> &&storage);
   explicit OfficeOpenXml(std::unique_ptr<access::ReadStorage> &storage);
+  // skips meta parsing, e.g. for snapshots
+  OfficeOpenXml(std::unique_ptr<access::ReadStorage> &&storage, FileMeta meta,
+                bool decrypted);
   OfficeOpenXml(const OfficeOpenXml &) = delete;
   OfficeOpenXml(OfficeOpenXml &&) noexcept;
   OfficeOpenXml &operator=(const OfficeOpenXml &) = delete;
@@ -38,6 +41,8 @@ public:
 
   void edit(const std::string &diff) final;
 
+  void releaseCache() noexcept final;
+
   void save(const access::Path &path) const final;
   void save(const access::Path &path, const std::string &password) const final;
 
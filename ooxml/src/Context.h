@@ -1,6 +1,8 @@
 #ifndef ODR_OOXML_CONTEXT_H
 #define ODR_OOXML_CONTEXT_H
 
+#include <common/InlineStyles.h>
+#include <common/StyleClasses.h>
 #include <common/TableCursor.h>
 #include <common/TableRange.h>
 #include <iostream>
@@ -18,21 +20,36 @@ struct FileMeta;
 namespace access {
 class ReadStorage;
 }
+
+namespace common {
+class HtmlWriter;
+class ResourceWriter;
+class XmlCache;
+}
 } // namespace odr
 
 namespace odr::ooxml {
 
+class SharedStrings;
+
 struct Context {
   const Config *config;
   const FileMeta *meta;
 
   const access::ReadStorage *storage;
+  common::XmlCache *xmlCache;
 
-  std::ostream *output;
+  common::HtmlWriter *output;
+  // side files of `Config::resourcePath`; null to inline the resources
+  common::ResourceWriter *resources{nullptr};
 
   std::unordered_map<std::string, std::list<std::string>> styleDependencies;
+  // `styleDependencies` resolved once the styles are translated
+  common::StyleClasses styleClasses;
+  // direct formatting of the content; docx
+  common::InlineStyles inlineStyles;
   std::unordered_map<std::string, std::string> relations;
-  std::vector<pugi::xml_node> sharedStrings; // xlsx
+  SharedStrings *sharedStrings{nullptr}; // xlsx
 
   std::uint32_t entry{0};
   common::TableRange tableRange;
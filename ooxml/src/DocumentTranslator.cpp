@@ -2,33 +2,33 @@
 #include <DocumentTranslator.h>
 #include <access/Path.h>
 #include <access/Storage.h>
-#include <access/StreamUtil.h>
+#include <common/HtmlWriter.h>
+#include <common/NameTable.h>
+#include <common/ResourceWriter.h>
 #include <common/StringUtil.h>
-#include <crypto/CryptoUtil.h>
 #include <cstring>
 #include <glog/logging.h>
 #include <odr/Config.h>
 #include <pugixml.hpp>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
 
 namespace odr::ooxml {
 
 namespace {
-void AlignmentTranslator(const pugi::xml_node &in, std::ostream &out,
+void AlignmentTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                          Context &) {
   out << "text-align:" << in.attribute("w:val").as_string() << ";";
 }
 
-void FontTranslator(const pugi::xml_node &in, std::ostream &out, Context &) {
+void FontTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
+                    Context &) {
   const auto fontAttr = in.attribute("w:cs");
   if (!fontAttr)
     return;
   out << "font-family:" << fontAttr.as_string() << ";";
 }
 
-void FontSizeTranslator(const pugi::xml_node &in, std::ostream &out,
+void FontSizeTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                         Context &) {
   const auto sizeAttr = in.attribute("w:val");
   if (!sizeAttr)
@@ -37,21 +37,23 @@ void FontSizeTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "font-size:" << size << "pt;";
 }
 
-void BoldTranslator(const pugi::xml_node &in, std::ostream &out, Context &) {
+void BoldTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
+                    Context &) {
   const auto valAttr = in.attribute("w:val");
   if (valAttr)
     return;
   out << "font-weight:bold;";
 }
 
-void ItalicTranslator(const pugi::xml_node &in, std::ostream &out, Context &) {
+void ItalicTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
+                      Context &) {
   const auto valAttr = in.attribute("w:val");
   if (valAttr)
     return;
   out << "font-style:italic;";
 }
 
-void UnderlineTranslator(const pugi::xml_node &in, std::ostream &out,
+void UnderlineTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                          Context &) {
   const auto valAttr = in.attribute("w:val");
   if (std::strcmp(valAttr.as_string(), "single") == 0)
@@ -59,7 +61,7 @@ void UnderlineTranslator(const pugi::xml_node &in, std::ostream &out,
   // TODO wont work with StrikeThroughTranslator
 }
 
-void StrikeThroughTranslator(const pugi::xml_node &in, std::ostream &out,
+void StrikeThroughTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                              Context &) {
   // TODO wont work with UnderlineTranslator
 
@@ -69,11 +71,13 @@ void StrikeThroughTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "text-decoration:line-through;";
 }
 
-void ShadowTranslator(const pugi::xml_node &, std::ostream &out, Context &) {
+void ShadowTranslator(const pugi::xml_node &, common::HtmlWriter &out,
+                      Context &) {
   out << "text-shadow:1pt 1pt;";
 }
 
-void ColorTranslator(const pugi::xml_node &in, std::ostream &out, Context &) {
+void ColorTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
+                     Context &) {
   const auto valAttr = in.attribute("w:val");
   if (std::strcmp(valAttr.as_string(), "auto") == 0)
     return;
@@ -83,7 +87,7 @@ void ColorTranslator(const pugi::xml_node &in, std::ostream &out, Context &) {
     out << "color:" << valAttr.as_string() << ";";
 }
 
-void HighlightTranslator(const pugi::xml_node &in, std::ostream &out,
+void HighlightTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                          Context &) {
   const auto valAttr = in.attribute("w:val");
   if (std::strcmp(valAttr.as_string(), "auto") == 0)
@@ -94,7 +98,7 @@ void HighlightTranslator(const pugi::xml_node &in, std::ostream &out,
     out << "background-color:" << valAttr.as_string() << ";";
 }
 
-void IndentationTranslator(const pugi::xml_node &in, std::ostream &out,
+void IndentationTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                            Context &) {
   const auto leftAttr = in.attribute("w:left");
   if (leftAttr)
@@ -105,7 +109,7 @@ void IndentationTranslator(const pugi::xml_node &in, std::ostream &out,
     out << "margin-right:" << rightAttr.as_float() / 1440.0f << "in;";
 }
 
-void TableCellWidthTranslator(const pugi::xml_node &in, std::ostream &out,
+void TableCellWidthTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                               Context &) {
   const auto widthAttr = in.attribute("w:w");
   const auto typeAttr = in.attribute("w:type");
@@ -117,8 +121,8 @@ void TableCellWidthTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "width:" << width << "in;";
 }
 
-void TableCellBorderTranslator(const pugi::xml_node &in, std::ostream &out,
-                               Context &) {
+void TableCellBorderTranslator(const pugi::xml_node &in,
+                               common::HtmlWriter &out, Context &) {
   auto translator = [&](const char *name, const pugi::xml_node &e) {
     out << name << ":";
 
@@ -154,7 +158,7 @@ void TableCellBorderTranslator(const pugi::xml_node &in, std::ostream &out,
     translator("border-right", top);
 }
 
-void translateStyleInline(const pugi::xml_node &in, std::ostream &out,
+void translateStyleInline(const pugi::xml_node &in, common::HtmlWriter &out,
                           Context &context) {
   for (auto &&e : in.children()) {
     const std::string element = e.name();
@@ -188,7 +192,7 @@ void translateStyleInline(const pugi::xml_node &in, std::ostream &out,
   }
 }
 
-void StyleClassTranslator(const pugi::xml_node &in, std::ostream &out,
+void StyleClassTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                           Context &context) {
   std::string name = "unknown";
   if (const auto nameAttr = in.attribute("w:styleId"); nameAttr) {
@@ -236,56 +240,60 @@ void DocumentTranslator::css(const pugi::xml_node &in, Context &context) {
 }
 
 namespace {
-void TextTranslator(const pugi::xml_text &in, std::ostream &out,
+void TextTranslator(const pugi::xml_text &in, common::HtmlWriter &out,
                     Context &context) {
-  std::string text = in.as_string();
-  common::StringUtil::findAndReplaceAll(text, "&", "&amp;");
-  common::StringUtil::findAndReplaceAll(text, "<", "&lt;");
-  common::StringUtil::findAndReplaceAll(text, ">", "&gt;");
-
   if (!context.config->editable) {
-    out << text;
+    out.text(in.as_string());
   } else {
     out << R"(<span contenteditable="true" data-odr-cid=")"
-        << context.currentTextTranslationIndex << "\">" << text << "</span>";
+        << context.currentTextTranslationIndex << "\">";
+    out.text(in.as_string());
+    out << "</span>";
     context.textTranslation[context.currentTextTranslationIndex] = &in;
     ++context.currentTextTranslationIndex;
   }
 }
 
-void StyleAttributeTranslator(const pugi::xml_node &in, std::ostream &out,
+void StyleAttributeTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                               Context &context) {
   const std::string prefix = in.name();
 
-  const pugi::xml_node style =
-      in.child((prefix + "Pr").c_str()).child((prefix + "Style").c_str());
-  if (style)
-    *context.output << " class=\"" << style.attribute("w:val").as_string()
-                    << "\"";
-
   const pugi::xml_node inlineStyle = in.child((prefix + "Pr").c_str());
-  if (inlineStyle && inlineStyle.first_child()) {
-    out << " style=\"";
-    translateStyleInline(inlineStyle, out, context);
-    out << "\"";
+  const pugi::xml_node style = inlineStyle.child((prefix + "Style").c_str());
+  // the direct formatting goes to `Context::inlineStyles` instead of a
+  // `style` attribute
+  common::HtmlWriter declarations;
+  if (inlineStyle.first_child())
+    translateStyleInline(inlineStyle, declarations, context);
+  if (!style && declarations.str().empty())
+    return;
+
+  out << " class=\"";
+  if (style) {
+    out.attribute(style.attribute("w:val").as_string());
+    if (!declarations.str().empty())
+      out << " ";
   }
+  if (!declarations.str().empty())
+    context.inlineStyles.write(declarations.str(), out);
+  out << "\"";
 }
 
-void ElementAttributeTranslator(const pugi::xml_node &in, std::ostream &out,
-                                Context &context) {
+void ElementAttributeTranslator(const pugi::xml_node &in,
+                                common::HtmlWriter &out, Context &context) {
   StyleAttributeTranslator(in, out, context);
 }
 
-void ElementChildrenTranslator(const pugi::xml_node &in, std::ostream &out,
-                               Context &context);
-void ElementTranslator(const pugi::xml_node &in, std::ostream &out,
+void ElementChildrenTranslator(const pugi::xml_node &in,
+                               common::HtmlWriter &out, Context &context);
+void ElementTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                        Context &context);
 
-void TabTranslator(const pugi::xml_node &, std::ostream &out, Context &) {
+void TabTranslator(const pugi::xml_node &, common::HtmlWriter &out, Context &) {
   out << "\t";
 }
 
-void ParagraphTranslator(const pugi::xml_node &in, std::ostream &out,
+void ParagraphTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                          Context &context) {
   const pugi::xml_node num = in.child("w:pPr").child("w:numPr");
   int listingLevel;
@@ -328,7 +336,7 @@ void ParagraphTranslator(const pugi::xml_node &in, std::ostream &out,
   }
 }
 
-void SpanTranslator(const pugi::xml_node &in, std::ostream &out,
+void SpanTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                     Context &context) {
   out << "<span";
   ElementAttributeTranslator(in, out, context);
@@ -337,14 +345,19 @@ void SpanTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "</span>";
 }
 
-void HyperlinkTranslator(const pugi::xml_node &in, std::ostream &out,
+void HyperlinkTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                          Context &context) {
   out << "<a";
 
-  if (const auto anchorAttr = in.attribute("w:anchor"); anchorAttr)
-    out << " href=\"#" << anchorAttr.as_string() << R"(" target="_self")";
-  else if (const auto rIdAttr = in.attribute("r:id"); rIdAttr)
-    out << " href=\"" << context.relations[rIdAttr.as_string()] << "\"";
+  if (const auto anchorAttr = in.attribute("w:anchor"); anchorAttr) {
+    out << " href=\"#";
+    out.attribute(anchorAttr.as_string());
+    out << R"(" target="_self")";
+  } else if (const auto rIdAttr = in.attribute("r:id"); rIdAttr) {
+    out << " href=\"";
+    out.attribute(context.relations[rIdAttr.as_string()]);
+    out << "\"";
+  }
 
   ElementAttributeTranslator(in, out, context);
 
@@ -353,13 +366,16 @@ void HyperlinkTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "</a>";
 }
 
-void BookmarkTranslator(const pugi::xml_node &in, std::ostream &out,
+void BookmarkTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                         Context &) {
-  if (const auto nameAttr = in.attribute("w:name"); nameAttr)
-    out << "<a id=\"" << nameAttr.as_string() << "\"/>";
+  if (const auto nameAttr = in.attribute("w:name"); nameAttr) {
+    out << "<a id=\"";
+    out.attribute(nameAttr.as_string());
+    out << "\"/>";
+  }
 }
 
-void TableTranslator(const pugi::xml_node &in, std::ostream &out,
+void TableTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                      Context &context) {
   out << R"(<table border="0" cellspacing="0" cellpadding="0")";
   ElementAttributeTranslator(in, out, context);
@@ -368,7 +384,7 @@ void TableTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "</table>";
 }
 
-void DrawingsTranslator(const pugi::xml_node &in, std::ostream &out,
+void DrawingsTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                         Context &context) {
   // ooxml is using amazing units
   // https://startbigthinksmall.wordpress.com/2010/01/04/points-inches-and-emus-measuring-units-in-office-open-xml/
@@ -394,7 +410,7 @@ void DrawingsTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "</div>";
 }
 
-void ImageTranslator(const pugi::xml_node &in, std::ostream &out,
+void ImageTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                      Context &context) {
   out << "<img style=\"width:100%;height:100%\"";
 
@@ -407,18 +423,25 @@ void ImageTranslator(const pugi::xml_node &in, std::ostream &out,
     const auto path = access::Path("word").join(context.relations[rIdAttr]);
     out << " alt=\"Error: image not found or unsupported: " << path << "\"";
     out << " src=\"";
-    std::string image = access::StreamUtil::read(*context.storage->read(path));
-    // hacky image/jpg working according to tom
-    out << "data:image/jpg;base64, ";
-    out << crypto::Util::base64Encode(image);
-    out << "\"";
+    if (context.resources != nullptr) {
+      out.attribute(context.resources->write(*context.storage, path));
+      out << R"(" loading="lazy")";
+    } else {
+      const auto image = context.storage->read(path);
+      if (!image)
+        throw access::FileNotFoundException(path.string());
+      // hacky image/jpg working according to tom
+      out << "data:image/jpg;base64, ";
+      out.base64(*image);
+      out << "\"";
+    }
   }
 
   out << "></img>";
 }
 
-void ElementChildrenTranslator(const pugi::xml_node &in, std::ostream &out,
-                               Context &context) {
+void ElementChildrenTranslator(const pugi::xml_node &in,
+                               common::HtmlWriter &out, Context &context) {
   for (auto &&n : in) {
     if (n.type() == pugi::node_pcdata)
       TextTranslator(n.text(), out, context);
@@ -427,48 +450,84 @@ void ElementChildrenTranslator(const pugi::xml_node &in, std::ostream &out,
   }
 }
 
-void ElementTranslator(const pugi::xml_node &in, std::ostream &out,
+enum class Element {
+  UNKNOWN,
+  SKIP,
+  TAB,
+  PARAGRAPH,
+  SPAN,
+  HYPERLINK,
+  BOOKMARK,
+  TABLE,
+  DRAWING,
+  IMAGE,
+  // substituted by a plain html element
+  TABLE_ROW,
+  TABLE_CELL,
+};
+
+constexpr auto elements = common::nameTable<Element>({
+    {"w:tab", Element::TAB},
+    {"w:p", Element::PARAGRAPH},
+    {"w:r", Element::SPAN},
+    {"w:hyperlink", Element::HYPERLINK},
+    {"w:bookmarkStart", Element::BOOKMARK},
+    {"w:tbl", Element::TABLE},
+    {"w:drawing", Element::DRAWING},
+    {"pic:pic", Element::IMAGE},
+    {"w:tr", Element::TABLE_ROW},
+    {"w:tc", Element::TABLE_CELL},
+    {"w:instrText", Element::SKIP},
+});
+
+void ElementTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                        Context &context) {
-  static std::unordered_map<std::string, const char *> substitution{
-      {"w:tr", "tr"},
-      {"w:tc", "td"},
-  };
-  static std::unordered_set<std::string> skippers{
-      "w:instrText",
-  };
-
-  const std::string element = in.name();
-  if (skippers.find(element) != skippers.end())
+  const char *substitution = nullptr;
+  switch (elements.find(in.name(), Element::UNKNOWN)) {
+  case Element::SKIP:
     return;
-
-  if (element == "w:tab")
+  case Element::TAB:
     TabTranslator(in, out, context);
-  else if (element == "w:p")
+    return;
+  case Element::PARAGRAPH:
     ParagraphTranslator(in, out, context);
-  else if (element == "w:r")
+    return;
+  case Element::SPAN:
     SpanTranslator(in, out, context);
-  else if (element == "w:hyperlink")
+    return;
+  case Element::HYPERLINK:
     HyperlinkTranslator(in, out, context);
-  else if (element == "w:bookmarkStart")
+    return;
+  case Element::BOOKMARK:
     BookmarkTranslator(in, out, context);
-  else if (element == "w:tbl")
+    return;
+  case Element::TABLE:
     TableTranslator(in, out, context);
-  else if (element == "w:drawing")
+    return;
+  case Element::DRAWING:
     DrawingsTranslator(in, out, context);
-  else if (element == "pic:pic")
+    return;
+  case Element::IMAGE:
     ImageTranslator(in, out, context);
-  else {
-    const auto it = substitution.find(element);
-    if (it != substitution.end()) {
-      out << "<" << it->second;
-      ElementAttributeTranslator(in, out, context);
-      out << ">";
-    }
-    ElementChildrenTranslator(in, out, context);
-    if (it != substitution.end()) {
-      out << "</" << it->second << ">";
-    }
+    return;
+  case Element::TABLE_ROW:
+    substitution = "tr";
+    break;
+  case Element::TABLE_CELL:
+    substitution = "td";
+    break;
+  case Element::UNKNOWN:
+    break;
   }
+
+  if (substitution != nullptr) {
+    out << "<" << substitution;
+    ElementAttributeTranslator(in, out, context);
+    out << ">";
+  }
+  ElementChildrenTranslator(in, out, context);
+  if (substitution != nullptr)
+    out << "</" << substitution << ">";
 }
 } // namespace
 
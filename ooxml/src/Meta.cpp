@@ -1,14 +1,104 @@
 #include <Meta.h>
 #include <access/Path.h>
 #include <access/Storage.h>
+#include <access/StorageUtil.h>
+#include <common/TablePosition.h>
+#include <common/XmlPullParser.h>
 #include <common/XmlUtil.h>
 #include <odr/Exception.h>
 #include <odr/Meta.h>
 #include <pugixml.hpp>
+#include <sstream>
+#include <stdexcept>
 #include <unordered_map>
 
 namespace odr::ooxml {
 
+namespace {
+// `dimension` is one of the first elements of a worksheet
+constexpr std::uint64_t dimensionPeekSize = 4096;
+
+// reads the used range of a worksheet from its first bytes; leaves the entry
+// untouched if it is not there
+void parseDimension(const access::ReadStorage &storage,
+                    const access::Path &path, FileMeta::Entry &entry) {
+  using Event = common::XmlPullParser::Event;
+
+  if (!storage.isFile(path))
+    return;
+  std::istringstream in(
+      access::StorageUtil::peek(storage, path, dimensionPeekSize));
+  common::XmlPullParser parser(in);
+  try {
+    while (true) {
+      switch (parser.next()) {
+      case Event::START_ELEMENT:
+        if (parser.depth() == 1)
+          break;
+        if (parser.name() == "dimension") {
+          const char *ref = parser.attribute("ref");
+          if (ref == nullptr)
+            return;
+          const std::string range = ref;
+          const auto separator = range.find(':');
+          const common::TablePosition end(range.substr(
+              separator == std::string::npos ? 0 : separator + 1));
+          entry.rowCount = end.row() + 1;
+          entry.columnCount = end.col() + 1;
+          return;
+        }
+        if (parser.name() == "sheetData")
+          return;
+        parser.skip();
+        break;
+      case Event::END_DOCUMENT:
+        return;
+      default:
+        break;
+      }
+    }
+  } catch (const common::NotXmlException &) {
+    // cut off before `dimension`
+  } catch (const std::invalid_argument &) {
+    // malformed reference
+  } catch (const std::out_of_range &) {
+    // row number out of range
+  }
+}
+
+// extended properties written by the producing application. they are tiny
+// compared to the main parts but may be stale, missing or malformed; an
+// empty document stands for the latter two
+pugi::xml_document parseApp(const access::ReadStorage &storage) {
+  static const access::Path path("docProps/app.xml");
+  if (!storage.isFile(path))
+    return {};
+  try {
+    return common::XmlUtil::parse(storage, path);
+  } catch (const std::exception &) {
+    // not needed to open the document
+  }
+  return {};
+}
+
+// reads a count from the extended properties; zero if it is missing
+std::uint32_t appCount(const pugi::xml_document &app, const char *name) {
+  return app.child("Properties").child(name).text().as_uint();
+}
+
+// counted from the file list without reading any part
+std::uint32_t countSlideParts(const access::ReadStorage &storage) {
+  static const access::Path slides("ppt/slides");
+  std::uint32_t result = 0;
+  storage.visit([&](const access::Path &path) {
+    if (path.childOf(slides) && (path.extension() == "xml") &&
+        storage.isFile(path))
+      ++result;
+  });
+  return result;
+}
+} // namespace
+
 FileMeta Meta::parseFileMeta(access::ReadStorage &storage) {
   static const std::unordered_map<access::Path, FileType> TYPES = {
       {"word/document.xml", FileType::OFFICE_OPEN_XML_DOCUMENT},
@@ -34,9 +124,23 @@ FileMeta Meta::parseFileMeta(access::ReadStorage &storage) {
 
   // TODO dont load content twice (happens in case of translation)
   switch (result.type) {
-  case FileType::OFFICE_OPEN_XML_DOCUMENT:
-    break;
+  case FileType::OFFICE_OPEN_XML_DOCUMENT: {
+    // pages only exist after layout; there is nothing to check against
+    const auto pages = appCount(parseApp(storage), "Pages");
+    if (pages > 0) {
+      result.entryCount = pages;
+      result.entries.resize(pages);
+    }
+  } break;
   case FileType::OFFICE_OPEN_XML_PRESENTATION: {
+    // checked against the file list, which is cheap
+    const auto slides = appCount(parseApp(storage), "Slides");
+    if ((slides > 0) && (slides == countSlideParts(storage))) {
+      result.entryCount = slides;
+      result.entries.resize(slides);
+      break;
+    }
+
     const auto ppt = common::XmlUtil::parse(storage, "ppt/presentation.xml");
     result.entryCount = 0;
     for (auto &&e : ppt.select_nodes("//p:sldId")) {
@@ -48,12 +152,16 @@ FileMeta Meta::parseFileMeta(access::ReadStorage &storage) {
   } break;
   case FileType::OFFICE_OPEN_XML_WORKBOOK: {
     const auto xls = common::XmlUtil::parse(storage, "xl/workbook.xml");
+    const auto xlsRelations = parseRelationships(storage, "xl/workbook.xml");
     result.entryCount = 0;
     for (auto &&e : xls.select_nodes("//sheet")) {
       ++result.entryCount;
       FileMeta::Entry entry;
       entry.name = e.node().attribute("name").as_string();
-      // TODO dimension
+      const auto it =
+          xlsRelations.find(e.node().attribute("r:id").as_string());
+      if (it != xlsRelations.end())
+        parseDimension(storage, access::Path("xl").join(it->second), entry);
       result.entries.emplace_back(entry);
     }
   } break;
@@ -3,12 +3,19 @@
 #include <DocumentTranslator.h>
 #include <Meta.h>
 #include <PresentationTranslator.h>
+#include <SharedStrings.h>
 #include <WorkbookTranslator.h>
 #include <access/CfbStorage.h>
 #include <access/Path.h>
 #include <access/StreamUtil.h>
 #include <access/ZipStorage.h>
 #include <common/Html.h>
+#include <common/HtmlWriter.h>
+#include <common/ResourceWriter.h>
+#include <common/StyleSheet.h>
+#include <common/TableRowIndex.h>
+#include <common/XmlCache.h>
+#include <common/XmlPullParser.h>
 #include <common/XmlUtil.h>
 #include <fstream>
 #include <odr/Config.h>
@@ -16,29 +23,63 @@
 #include <odr/Meta.h>
 #include <ooxml/OfficeOpenXml.h>
 #include <pugixml.hpp>
+#include <unordered_set>
 
 namespace odr::ooxml {
 
 namespace {
-void generateStyle_(std::ofstream &out, Context &context) {
+std::unordered_map<std::string, std::string>
+parseRelationships_(Context &context, const access::Path &path) {
+  const auto relPath =
+      path.parent().join("_rels").join(path.basename() + ".rels");
+  if (!context.storage->isFile(relPath))
+    return {};
+  return Meta::parseRelationships(*context.xmlCache->get(relPath));
+}
+
+// style part of the document; null for presentations
+std::shared_ptr<const common::StyleSheet> documentStyle_(Context &context) {
+  switch (context.meta->type) {
+  case FileType::OFFICE_OPEN_XML_DOCUMENT:
+    return common::StyleSheetCache::instance().get(
+        common::StyleSheetCache::key("docx", *context.storage,
+                                     "word/styles.xml"),
+        [&]() {
+          return common::StyleSheet::compile(context, [&]() {
+            const auto styles = context.xmlCache->get("word/styles.xml");
+            DocumentTranslator::css(styles->document_element(), context);
+          });
+        });
+  case FileType::OFFICE_OPEN_XML_PRESENTATION:
+    return nullptr;
+  case FileType::OFFICE_OPEN_XML_WORKBOOK:
+    return common::StyleSheetCache::instance().get(
+        common::StyleSheetCache::key("xlsx", *context.storage,
+                                     "xl/styles.xml"),
+        [&]() {
+          return common::StyleSheet::compile(context, [&]() {
+            const auto styles = context.xmlCache->get("xl/styles.xml");
+            WorkbookTranslator::css(styles->document_element(), context);
+          });
+        });
+  default:
+    throw std::invalid_argument("file.getMeta().type");
+  }
+}
+
+void generateStyle_(common::HtmlWriter &out, Context &context,
+                    const common::StyleSheet *documentStyle) {
   // default css
   out << common::Html::odfDefaultStyle();
 
-  switch (context.meta->type) {
-  case FileType::OFFICE_OPEN_XML_DOCUMENT: {
-    const auto styles =
-        common::XmlUtil::parse(*context.storage, "word/styles.xml");
-    DocumentTranslator::css(styles.document_element(), context);
-  } break;
-  case FileType::OFFICE_OPEN_XML_PRESENTATION: {
+  if (context.meta->type == FileType::OFFICE_OPEN_XML_PRESENTATION) {
     // TODO that should go to `PresentationTranslator::css`
 
     // TODO duplication in generateContent_
-    const auto ppt =
-        common::XmlUtil::parse(*context.storage, "ppt/presentation.xml");
-    const auto sizeEle = ppt.select_node("//p:sldSz").node();
+    const auto ppt = context.xmlCache->get("ppt/presentation.xml");
+    const auto sizeEle = ppt->select_node("//p:sldSz").node();
     if (!sizeEle)
-      break;
+      return;
     const float widthIn = sizeEle.attribute("cx").as_float() / 914400.0f;
     const float heightIn = sizeEle.attribute("cy").as_float() / 914400.0f;
 
@@ -46,93 +87,170 @@ void generateStyle_(std::ofstream &out, Context &context) {
     out << "width:" << widthIn << "in;";
     out << "height:" << heightIn << "in;";
     out << "}";
-  } break;
-  case FileType::OFFICE_OPEN_XML_WORKBOOK: {
-    const auto styles =
-        common::XmlUtil::parse(*context.storage, "xl/styles.xml");
-    WorkbookTranslator::css(styles.document_element(), context);
-  } break;
-  default:
-    throw std::invalid_argument("file.getMeta().type");
   }
+
+  if (documentStyle == nullptr)
+    return;
+  // only workbooks write their classes through `Context::styleClasses`
+  if (context.meta->type != FileType::OFFICE_OPEN_XML_WORKBOOK) {
+    out << documentStyle->css;
+    // after the named styles to override them
+    context.inlineStyles.css(out);
+    return;
+  }
+  std::unordered_set<std::string> used;
+  if (context.config->pruneStyles)
+    used = context.styleClasses.used(context.styleDependencies);
+  if (context.config->flattenStyles)
+    context.styleClasses.css(out,
+                             context.config->pruneStyles ? &used : nullptr);
+  else if (context.config->pruneStyles)
+    out << documentStyle->prune(used);
+  else
+    out << documentStyle->css;
 }
 
-void generateScript_(std::ofstream &out, Context &) {
+void generateScript_(common::HtmlWriter &out, Context &) {
   out << common::Html::defaultScript();
 }
 
-void generateContent_(Context &context) {
+// rows of a worksheet by their offset within the decompressed xml
+struct SheetIndex {
+  common::TableRowIndex rows;
+  // only for zip storages
+  std::unique_ptr<access::ZipReader::Checkpoints> checkpoints;
+};
+using SheetIndices =
+    std::unordered_map<access::Path, std::unique_ptr<SheetIndex>>;
+
+std::unique_ptr<SheetIndex> indexSheet_(const access::ReadStorage &storage,
+                                        const access::Path &path) {
+  auto result = std::make_unique<SheetIndex>();
+  std::unique_ptr<std::istream> in;
+  const auto zip = dynamic_cast<const access::ZipReader *>(&storage);
+  if (zip != nullptr) {
+    result->checkpoints = std::make_unique<access::ZipReader::Checkpoints>();
+    in = zip->read(path, *result->checkpoints);
+  } else {
+    in = storage.read(path);
+  }
+  if (!in)
+    throw access::FileNotFoundException(path.string());
+  common::XmlPullParser parser(*in);
+  result->rows = WorkbookTranslator::indexRows(parser);
+
+  if (result->checkpoints) {
+    std::vector<std::uint64_t> offsets;
+    for (auto &&mark : result->rows.marks()) {
+      offsets.push_back(mark.offset);
+    }
+    result->checkpoints->retain(offsets);
+  }
+  return result;
+}
+
+std::unique_ptr<std::istream> readSheet_(const access::ReadStorage &storage,
+                                         const access::Path &path,
+                                         const SheetIndex &index,
+                                         const std::uint64_t offset) {
+  if (index.checkpoints) {
+    const auto &zip = dynamic_cast<const access::ZipReader &>(storage);
+    return zip.read(path, *index.checkpoints, offset);
+  }
+  auto result = storage.read(path);
+  if (result && !result->seekg(offset)) {
+    result = storage.read(path);
+    result->ignore(offset);
+  }
+  return result;
+}
+
+void translateSheetStreaming_(const access::Path &path, Context &context,
+                              SheetIndices &sheetIndices) {
+  auto in = context.storage->read(path);
+  if (!in)
+    throw access::FileNotFoundException(path.string());
+
+  // for a window of rows the worksheet head is followed by the rows from the
+  // closest mark on; the rows in between are never read
+  if (context.config->tableOffsetRows > 0) {
+    auto &index = sheetIndices[path];
+    if (!index)
+      index = indexSheet_(*context.storage, path);
+    if (!index->rows.empty()) {
+      const auto &mark = index->rows.find(context.config->tableOffsetRows);
+      if (mark.row > 0) {
+        std::string head(index->rows.begin(), '\0');
+        in->read(head.data(), head.size());
+        in = access::StreamUtil::prepend(
+            std::move(head),
+            readSheet_(*context.storage, path, *index, mark.offset));
+      }
+    }
+  }
+
+  common::XmlPullParser parser(*in);
+  if (parser.next() != common::XmlPullParser::Event::START_ELEMENT)
+    throw common::NotXmlException();
+  WorkbookTranslator::html(parser, context);
+}
+
+void generateContent_(Context &context, SheetIndices &sheetIndices) {
   context.entry = 0;
 
   switch (context.meta->type) {
   case FileType::OFFICE_OPEN_XML_DOCUMENT: {
-    const auto content =
-        common::XmlUtil::parse(*context.storage, "word/document.xml");
-    context.relations =
-        Meta::parseRelationships(*context.storage, "word/document.xml");
+    const auto content = context.xmlCache->get("word/document.xml");
+    context.relations = parseRelationships_(context, "word/document.xml");
 
-    const auto body = content.child("w:document").child("w:body");
+    const auto body = content->child("w:document").child("w:body");
     DocumentTranslator::html(body, context);
   } break;
   case FileType::OFFICE_OPEN_XML_PRESENTATION: {
-    const auto ppt =
-        common::XmlUtil::parse(*context.storage, "ppt/presentation.xml");
+    const auto ppt = context.xmlCache->get("ppt/presentation.xml");
     const auto pptRelations =
-        Meta::parseRelationships(*context.storage, "ppt/presentation.xml");
+        parseRelationships_(context, "ppt/presentation.xml");
 
-    for (auto &&e : ppt.select_nodes("//p:sldId")) {
+    for (auto &&e : ppt->select_nodes("//p:sldId")) {
       const std::string rId = e.node().attribute("r:id").as_string();
 
       const auto path = access::Path("ppt").join(pptRelations.at(rId));
-      const auto content = common::XmlUtil::parse(*context.storage, path);
-      context.relations = Meta::parseRelationships(*context.storage, path);
+      const auto content = context.xmlCache->get(path);
+      context.relations = parseRelationships_(context, path);
 
       if ((context.config->entryOffset > 0) ||
           (context.config->entryCount > 0)) {
         if ((context.entry >= context.config->entryOffset) &&
             (context.entry <
              context.config->entryOffset + context.config->entryCount)) {
-          PresentationTranslator::html(content, context);
+          PresentationTranslator::html(*content, context);
         }
       } else {
-        PresentationTranslator::html(content, context);
+        PresentationTranslator::html(*content, context);
       }
 
       ++context.entry;
     }
   } break;
   case FileType::OFFICE_OPEN_XML_WORKBOOK: {
-    const auto xls =
-        common::XmlUtil::parse(*context.storage, "xl/workbook.xml");
-    const auto xlsRelations =
-        Meta::parseRelationships(*context.storage, "xl/workbook.xml");
-
-    // TODO this breaks back translation
-    pugi::xml_document sharedStrings;
-    if (context.storage->isFile("xl/sharedStrings.xml")) {
-      sharedStrings =
-          common::XmlUtil::parse(*context.storage, "xl/sharedStrings.xml");
-      for (auto &&e : sharedStrings.select_nodes("//si")) {
-        context.sharedStrings.push_back(e.node());
-      }
-    }
+    const auto xls = context.xmlCache->get("xl/workbook.xml");
+    const auto xlsRelations = parseRelationships_(context, "xl/workbook.xml");
 
-    for (auto &&e : xls.select_nodes("//sheet")) {
+    for (auto &&e : xls->select_nodes("//sheet")) {
       const std::string rId = e.node().attribute("r:id").as_string();
 
       const auto path = access::Path("xl").join(xlsRelations.at(rId));
-      const auto content = common::XmlUtil::parse(*context.storage, path);
-      context.relations = Meta::parseRelationships(*context.storage, path);
 
-      if ((context.config->entryOffset > 0) ||
-          (context.config->entryCount > 0)) {
-        if ((context.entry >= context.config->entryOffset) &&
-            (context.entry <
-             context.config->entryOffset + context.config->entryCount)) {
-          WorkbookTranslator::html(content, context);
-        }
-      } else {
-        WorkbookTranslator::html(content, context);
+      if (((context.config->entryOffset == 0) &&
+           (context.config->entryCount == 0)) ||
+          ((context.entry >= context.config->entryOffset) &&
+           (context.entry <
+            context.config->entryOffset + context.config->entryCount))) {
+        context.relations = parseRelationships_(context, path);
+        if (context.config->streaming && !context.config->editable)
+          translateSheetStreaming_(path, context, sheetIndices);
+        else
+          WorkbookTranslator::html(*context.xmlCache->get(path), context);
       }
 
       ++context.entry;
@@ -156,6 +274,7 @@ public:
     try {
       storage_ = std::make_unique<access::ZipReader>(path);
       meta_ = Meta::parseFileMeta(*storage_);
+      xmlCache_.setStorage(storage_.get());
       return;
     } catch (access::NoZipFileException &) {
     }
@@ -163,6 +282,7 @@ public:
     try {
       storage_ = std::make_unique<access::CfbReader>(path);
       meta_ = Meta::parseFileMeta(*storage_);
+      xmlCache_.setStorage(storage_.get());
       return;
     } catch (access::NoCfbFileException &) {
     }
@@ -173,11 +293,20 @@ public:
   explicit Impl(std::unique_ptr<access::ReadStorage> &&storage) {
     meta_ = Meta::parseFileMeta(*storage);
     storage_ = std::move(storage);
+    xmlCache_.setStorage(storage_.get());
   }
 
   explicit Impl(std::unique_ptr<access::ReadStorage> &storage) {
     meta_ = Meta::parseFileMeta(*storage);
     storage_ = std::move(storage);
+    xmlCache_.setStorage(storage_.get());
+  }
+
+  Impl(std::unique_ptr<access::ReadStorage> &&storage, FileMeta meta,
+       const bool decrypted)
+      : storage_{std::move(storage)}, meta_{std::move(meta)},
+        decrypted_{decrypted} {
+    xmlCache_.setStorage(storage_.get());
   }
 
   FileType type() const noexcept { return meta_.type; }
@@ -211,33 +340,80 @@ public:
     const std::string decryptedPackage = util.decrypt(encryptedPackage, key);
     storage_ = std::make_unique<access::ZipReader>(decryptedPackage, false);
     meta_ = Meta::parseFileMeta(*storage_);
+    xmlCache_.setStorage(storage_.get());
+    sheetIndices_.clear();
+    sharedStrings_.reset();
     decrypted_ = true;
     return true;
   }
 
   bool translate(const access::Path &path, const Config &config) {
     // TODO throw if not decrypted
-    std::ofstream out(path);
-    if (!out.is_open())
+    std::ofstream file(path);
+    if (!file.is_open())
       return false;
+    common::HtmlWriter out(file);
 
     context_ = {};
     context_.config = &config;
     context_.meta = &meta_;
     context_.storage = storage_.get();
+    context_.xmlCache = &xmlCache_;
     context_.output = &out;
+    std::unique_ptr<common::ResourceWriter> resources;
+    if (!config.resourcePath.empty())
+      resources = std::make_unique<common::ResourceWriter>(
+          config.resourcePath, path.parent().string());
+    context_.resources = resources.get();
+    if ((meta_.type == FileType::OFFICE_OPEN_XML_WORKBOOK) &&
+        storage_->isFile("xl/sharedStrings.xml")) {
+      if (!sharedStrings_)
+        sharedStrings_ = std::make_unique<SharedStrings>(
+            *storage_, "xl/sharedStrings.xml");
+      context_.sharedStrings = sharedStrings_.get();
+    }
+
+    xmlCache_.setLimit(config.xmlCacheLimit);
 
     out << common::Html::doctype();
     out << "<html><head>";
     out << common::Html::defaultHeaders();
-    out << "<style>";
-    generateStyle_(out, context_);
-    out << "</style>";
-    out << "</head>";
-
-    out << "<body " << common::Html::bodyAttributes(config) << ">";
-    generateContent_(context_);
-    out << "</body>";
+    const auto documentStyle = documentStyle_(context_);
+    if (documentStyle)
+      documentStyle->link(context_);
+    if (config.flattenStyles &&
+        (meta_.type == FileType::OFFICE_OPEN_XML_WORKBOOK))
+      context_.styleClasses.flatten({documentStyle.get()},
+                                    context_.styleDependencies);
+    else
+      context_.styleClasses.resolve(context_.styleDependencies);
+
+    const auto generateHead = [&]() {
+      out << "<style>";
+      generateStyle_(out, context_, documentStyle.get());
+      out << "</style>";
+      out << "</head>";
+    };
+    const auto generateBody = [&]() {
+      common::HtmlWriter &body = *context_.output;
+      body << "<body " << common::Html::bodyAttributes(config) << ">";
+      generateContent_(context_, sheetIndices_);
+      body << "</body>";
+    };
+    if (config.pruneStyles ||
+        (meta_.type == FileType::OFFICE_OPEN_XML_DOCUMENT)) {
+      // the body goes first to learn which styles it uses and to collect the
+      // direct formatting of documents
+      common::HtmlWriter body;
+      context_.output = &body;
+      generateBody();
+      context_.output = &out;
+      generateHead();
+      out << body.str();
+    } else {
+      generateHead();
+      generateBody();
+    }
 
     out << "<script>";
     generateScript_(out, context_);
@@ -246,12 +422,20 @@ public:
 
     context_.config = nullptr;
     context_.output = nullptr;
-    out.close();
+    context_.resources = nullptr;
+    out.flush();
+    file.close();
     return true;
   }
 
   bool edit(const std::string &) { return false; }
 
+  void releaseCache() noexcept {
+    xmlCache_.clear();
+    sheetIndices_.clear();
+    sharedStrings_.reset();
+  }
+
   bool save(const access::Path &) const { return false; }
 
   bool save(const access::Path &, const std::string &) const { return false; }
@@ -264,8 +448,9 @@ private:
   bool decrypted_{false};
 
   Context context_;
-  pugi::xml_document style_;
-  pugi::xml_document content_;
+  common::XmlCache xmlCache_;
+  SheetIndices sheetIndices_;
+  std::unique_ptr<SharedStrings> sharedStrings_;
 };
 
 OfficeOpenXml::OfficeOpenXml(const char *path)
@@ -283,6 +468,11 @@ OfficeOpenXml::OfficeOpenXml(std::unique_ptr<access::ReadStorage> &&storage)
 OfficeOpenXml::OfficeOpenXml(std::unique_ptr<access::ReadStorage> &storage)
     : impl_(std::make_unique<Impl>(storage)) {}
 
+OfficeOpenXml::OfficeOpenXml(std::unique_ptr<access::ReadStorage> &&storage,
+                             FileMeta meta, const bool decrypted)
+    : impl_(std::make_unique<Impl>(std::move(storage), std::move(meta),
+                                   decrypted)) {}
+
 OfficeOpenXml::OfficeOpenXml(OfficeOpenXml &&) noexcept = default;
 
 OfficeOpenXml &OfficeOpenXml::operator=(OfficeOpenXml &&) noexcept = default;
@@ -317,6 +507,8 @@ void OfficeOpenXml::translate(const access::Path &path, const Config &config) {
 
 void OfficeOpenXml::edit(const std::string &diff) { impl_->edit(diff); }
 
+void OfficeOpenXml::releaseCache() noexcept { impl_->releaseCache(); }
+
 void OfficeOpenXml::save(const access::Path &path) const { impl_->save(path); }
 
 void OfficeOpenXml::save(const access::Path &path,
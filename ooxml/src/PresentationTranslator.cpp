@@ -2,21 +2,21 @@
 #include <PresentationTranslator.h>
 #include <access/Path.h>
 #include <access/Storage.h>
-#include <access/StreamUtil.h>
+#include <common/HtmlWriter.h>
+#include <common/NameTable.h>
+#include <common/ResourceWriter.h>
 #include <common/StringUtil.h>
-#include <crypto/CryptoUtil.h>
 #include <cstring>
 #include <glog/logging.h>
 #include <odr/Config.h>
 #include <pugixml.hpp>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
 
 namespace odr::ooxml {
 
 namespace {
-void XfrmTranslator(const pugi::xml_node &in, std::ostream &out, Context &) {
+void XfrmTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
+                    Context &) {
   if (const auto offEle = in.child("a:off"); offEle) {
     const float xIn = offEle.attribute("x").as_float() / 914400.0f;
     const float yIn = offEle.attribute("y").as_float() / 914400.0f;
@@ -34,7 +34,7 @@ void XfrmTranslator(const pugi::xml_node &in, std::ostream &out, Context &) {
 }
 
 void BorderTranslator(const std::string &property, const pugi::xml_node &in,
-                      std::ostream &out, Context &) {
+                      common::HtmlWriter &out, Context &) {
   const auto wAttr = in.attribute("w");
   if (!wAttr)
     return;
@@ -54,8 +54,8 @@ void BorderTranslator(const std::string &property, const pugi::xml_node &in,
   out << ";";
 }
 
-void BackgroundColorTranslator(const pugi::xml_node &in, std::ostream &out,
-                               Context &) {
+void BackgroundColorTranslator(const pugi::xml_node &in,
+                               common::HtmlWriter &out, Context &) {
   const auto colorEle = in.child("a:srgbClr");
   if (!colorEle)
     return;
@@ -71,8 +71,8 @@ void BackgroundColorTranslator(const pugi::xml_node &in, std::ostream &out,
   out << ";";
 }
 
-void MarginAttributesTranslator(const pugi::xml_node &in, std::ostream &out,
-                                Context &) {
+void MarginAttributesTranslator(const pugi::xml_node &in,
+                                common::HtmlWriter &out, Context &) {
   const auto marLAttr = in.attribute("marL");
   if (marLAttr) {
     float marLIn = marLAttr.as_float() / 914400.0f;
@@ -86,8 +86,8 @@ void MarginAttributesTranslator(const pugi::xml_node &in, std::ostream &out,
   }
 }
 
-void TableCellPropertyTranslator(const pugi::xml_node &in, std::ostream &out,
-                                 Context &context) {
+void TableCellPropertyTranslator(const pugi::xml_node &in,
+                                 common::HtmlWriter &out, Context &context) {
   MarginAttributesTranslator(in, out, context);
 
   for (auto &&e : in) {
@@ -106,8 +106,8 @@ void TableCellPropertyTranslator(const pugi::xml_node &in, std::ostream &out,
   }
 }
 
-void DefaultPropertyTransaltor(const pugi::xml_node &in, std::ostream &out,
-                               Context &context) {
+void DefaultPropertyTransaltor(const pugi::xml_node &in,
+                               common::HtmlWriter &out, Context &context) {
   MarginAttributesTranslator(in, out, context);
 
   const auto szAttr = in.attribute("sz");
@@ -138,24 +138,21 @@ void DefaultPropertyTransaltor(const pugi::xml_node &in, std::ostream &out,
 void PresentationTranslator::css(const pugi::xml_node &, Context &) {}
 
 namespace {
-void TextTranslator(const pugi::xml_text &in, std::ostream &out,
+void TextTranslator(const pugi::xml_text &in, common::HtmlWriter &out,
                     Context &context) {
-  std::string text = in.as_string();
-  common::StringUtil::findAndReplaceAll(text, "&", "&amp;");
-  common::StringUtil::findAndReplaceAll(text, "<", "&lt;");
-  common::StringUtil::findAndReplaceAll(text, ">", "&gt;");
-
   if (!context.config->editable) {
-    out << text;
+    out.text(in.as_string());
   } else {
     out << R"(<span contenteditable="true" data-odr-cid=")"
-        << context.currentTextTranslationIndex << "\">" << text << "</span>";
+        << context.currentTextTranslationIndex << "\">";
+    out.text(in.as_string());
+    out << "</span>";
     context.textTranslation[context.currentTextTranslationIndex] = &in;
     ++context.currentTextTranslationIndex;
   }
 }
 
-void StyleAttributeTranslator(const pugi::xml_node &in, std::ostream &out,
+void StyleAttributeTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                               Context &context) {
   const auto pPr = in.child("a:pPr");
   const auto rPr = in.child("a:rPr");
@@ -189,17 +186,17 @@ void StyleAttributeTranslator(const pugi::xml_node &in, std::ostream &out,
   }
 }
 
-void ElementAttributeTranslator(const pugi::xml_node &in, std::ostream &out,
-                                Context &context) {
+void ElementAttributeTranslator(const pugi::xml_node &in,
+                                common::HtmlWriter &out, Context &context) {
   StyleAttributeTranslator(in, out, context);
 }
 
-void ElementChildrenTranslator(const pugi::xml_node &in, std::ostream &out,
-                               Context &context);
-void ElementTranslator(const pugi::xml_node &in, std::ostream &out,
+void ElementChildrenTranslator(const pugi::xml_node &in,
+                               common::HtmlWriter &out, Context &context);
+void ElementTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                        Context &context);
 
-void ParagraphTranslator(const pugi::xml_node &in, std::ostream &out,
+void ParagraphTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                          Context &context) {
   out << "<p";
   ElementAttributeTranslator(in, out, context);
@@ -243,7 +240,7 @@ void ParagraphTranslator(const pugi::xml_node &in, std::ostream &out,
   out << "</p>";
 }
 
-void SpanTranslator(const pugi::xml_node &in, std::ostream &out,
+void SpanTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                     Context &context) {
   bool link = false;
   const auto hlinkClick = in.child("a:rPr").child("a:hlinkClick");
@@ -251,7 +248,9 @@ void SpanTranslator(const pugi::xml_node &in, std::ostream &out,
     const auto rIdAttr = hlinkClick.attribute("r:id");
     const std::string href = context.relations[rIdAttr.as_string()];
     link = true;
-    out << "<a href=\"" << href << "\">";
+    out << "<a href=\"";
+    out.attribute(href);
+    out << "\">";
   }
 
   out << "<span";
@@ -264,14 +263,14 @@ void SpanTranslator(const pugi::xml_node &in, std::ostream &out,
     out << "</a>";
 }
 
-void SlideTranslator(const pugi::xml_node &in, std::ostream &out,
+void SlideTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                      Context &context) {
   out << "<div class=\"slide\">";
   ElementChildrenTranslator(in, out, context);
   out << "</div>";
 }
 
-void TableTranslator(const pugi::xml_node &in, std::ostream &out,
+void TableTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                      Context &context) {
   out << R"(<table border="0" cellspacing="0" cellpadding="0")";
   ElementAttributeTranslator(in, out, context);
@@ -281,7 +280,7 @@ void TableTranslator(const pugi::xml_node &in, std::ostream &out,
 }
 
 // TODO duplicated in document translation
-void ImageTranslator(const pugi::xml_node &in, std::ostream &out,
+void ImageTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                      Context &context) {
   out << "<img";
   ElementAttributeTranslator(in, out, context);
@@ -296,18 +295,25 @@ void ImageTranslator(const pugi::xml_node &in, std::ostream &out,
         access::Path("ppt/slides").join(context.relations[rIdAttr.as_string()]);
     out << " alt=\"Error: image not found or unsupported: " << path << "\"";
     out << " src=\"";
-    std::string image = access::StreamUtil::read(*context.storage->read(path));
-    // hacky image/jpg working according to tom
-    out << "data:image/jpg;base64, ";
-    out << crypto::Util::base64Encode(image);
-    out << "\"";
+    if (context.resources != nullptr) {
+      out.attribute(context.resources->write(*context.storage, path));
+      out << R"(" loading="lazy")";
+    } else {
+      const auto image = context.storage->read(path);
+      if (!image)
+        throw access::FileNotFoundException(path.string());
+      // hacky image/jpg working according to tom
+      out << "data:image/jpg;base64, ";
+      out.base64(*image);
+      out << "\"";
+    }
   }
 
   out << "></img>";
 }
 
-void ElementChildrenTranslator(const pugi::xml_node &in, std::ostream &out,
-                               Context &context) {
+void ElementChildrenTranslator(const pugi::xml_node &in,
+                               common::HtmlWriter &out, Context &context) {
   for (auto &&n : in) {
     if (n.type() == pugi::node_pcdata)
       TextTranslator(n.text(), out, context);
@@ -316,44 +322,85 @@ void ElementChildrenTranslator(const pugi::xml_node &in, std::ostream &out,
   }
 }
 
-void ElementTranslator(const pugi::xml_node &in, std::ostream &out,
+enum class Element {
+  UNKNOWN,
+  PARAGRAPH,
+  SPAN,
+  SLIDE,
+  TABLE,
+  IMAGE,
+  // substituted by a plain html element
+  SHAPE,
+  GRAPHIC_FRAME,
+  TABLE_GRID,
+  TABLE_COLUMN,
+  TABLE_ROW,
+  TABLE_CELL,
+};
+
+constexpr auto elements = common::nameTable<Element>({
+    {"a:p", Element::PARAGRAPH},
+    {"a:r", Element::SPAN},
+    {"p:cSld", Element::SLIDE},
+    {"a:tbl", Element::TABLE},
+    {"p:pic", Element::IMAGE},
+    {"p:sp", Element::SHAPE},
+    {"p:graphicFrame", Element::GRAPHIC_FRAME},
+    {"a:tblGrid", Element::TABLE_GRID},
+    {"a:gridCol", Element::TABLE_COLUMN},
+    {"a:tr", Element::TABLE_ROW},
+    {"a:tc", Element::TABLE_CELL},
+});
+
+void ElementTranslator(const pugi::xml_node &in, common::HtmlWriter &out,
                        Context &context) {
-  static std::unordered_map<std::string, const char *> substitution{
-      {"p:sp", "div"},
-      {"p:graphicFrame", "div"},
-      {"a:tblGrid", "colgroup"},
-      {"a:gridCol", "col"},
-      {"a:tr", "tr"},
-      {"a:tc", "td"},
-  };
-  static std::unordered_set<std::string> skippers{};
-
-  const std::string element = in.name();
-  if (skippers.find(element) != skippers.end())
-    return;
-
-  if (element == "a:p")
+  const char *substitution = nullptr;
+  switch (elements.find(in.name(), Element::UNKNOWN)) {
+  case Element::PARAGRAPH:
     ParagraphTranslator(in, out, context);
-  else if (element == "a:r")
+    return;
+  case Element::SPAN:
     SpanTranslator(in, out, context);
-  else if (element == "p:cSld")
+    return;
+  case Element::SLIDE:
     SlideTranslator(in, out, context);
-  else if (element == "a:tbl")
+    return;
+  case Element::TABLE:
     TableTranslator(in, out, context);
-  else if (element == "p:pic")
+    return;
+  case Element::IMAGE:
     ImageTranslator(in, out, context);
-  else {
-    const auto it = substitution.find(element);
-    if (it != substitution.end()) {
-      out << "<" << it->second;
-      ElementAttributeTranslator(in, out, context);
-      out << ">";
-    }
-    ElementChildrenTranslator(in, out, context);
-    if (it != substitution.end()) {
-      out << "</" << it->second << ">";
-    }
+    return;
+  case Element::SHAPE:
+    substitution = "div";
+    break;
+  case Element::GRAPHIC_FRAME:
+    substitution = "div";
+    break;
+  case Element::TABLE_GRID:
+    substitution = "colgroup";
+    break;
+  case Element::TABLE_COLUMN:
+    substitution = "col";
+    break;
+  case Element::TABLE_ROW:
+    substitution = "tr";
+    break;
+  case Element::TABLE_CELL:
+    substitution = "td";
+    break;
+  case Element::UNKNOWN:
+    break;
+  }
+
+  if (substitution != nullptr) {
+    out << "<" << substitution;
+    ElementAttributeTranslator(in, out, context);
+    out << ">";
   }
+  ElementChildrenTranslator(in, out, context);
+  if (substitution != nullptr)
+    out << "</" << substitution << ">";
 }
 } // namespace
 
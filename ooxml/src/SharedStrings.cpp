@@ -0,0 +1,86 @@
+#include <SharedStrings.h>
+#include <access/Storage.h>
+#include <access/StorageUtil.h>
+#include <common/HtmlWriter.h>
+#include <common/XmlPullParser.h>
+#include <common/XmlUtil.h>
+#include <istream>
+#include <pugixml.hpp>
+#include <stdexcept>
+#include <streambuf>
+
+namespace odr::ooxml {
+
+namespace {
+// reads `xml_` without copying it
+class ViewBuf final : public std::streambuf {
+public:
+  explicit ViewBuf(const std::string &data) {
+    char *begin = const_cast<char *>(data.data());
+    setg(begin, begin, begin + data.size());
+  }
+};
+} // namespace
+
+SharedStrings::SharedStrings(const access::ReadStorage &storage,
+                             access::Path path)
+    : storage_{storage}, path_{std::move(path)} {}
+
+std::uint32_t SharedStrings::size() {
+  scan_();
+  return ranges_.size();
+}
+
+pugi::xml_document SharedStrings::get(const std::uint32_t index) {
+  scan_();
+  const Range &range = ranges_.at(index);
+  return common::XmlUtil::parse(xml_.substr(range.offset, range.size));
+}
+
+const std::string &SharedStrings::html(const std::uint32_t index,
+                                       const Renderer &renderer) {
+  const auto it = html_.find(index);
+  if (it != html_.end())
+    return it->second;
+
+  const auto si = get(index);
+  common::HtmlWriter out;
+  renderer(si.document_element(), out);
+  return html_.emplace(index, out.str()).first->second;
+}
+
+void SharedStrings::scan_() {
+  using Event = common::XmlPullParser::Event;
+
+  if (scanned_)
+    return;
+
+  ranges_.clear();
+  xml_ = access::StorageUtil::read(storage_, path_);
+  ViewBuf buffer(xml_);
+  std::istream in(&buffer);
+  common::XmlPullParser parser(in);
+  while (true) {
+    switch (parser.next()) {
+    case Event::START_ELEMENT:
+      if (parser.depth() == 1)
+        break;
+      if ((parser.depth() == 2) && (parser.name() == "si")) {
+        const std::uint64_t offset = parser.offset();
+        parser.skip();
+        ranges_.push_back(
+            {offset, static_cast<std::uint32_t>(parser.endOffset() - offset)});
+      } else {
+        parser.skip();
+      }
+      break;
+    case Event::END_DOCUMENT:
+      scanned_ = true;
+      return;
+    default:
+      break;
+    }
+  }
+}
+
+} // namespace odr::ooxml
@@ -0,0 +1,59 @@
+#ifndef ODR_OOXML_SHARED_STRINGS_H
+#define ODR_OOXML_SHARED_STRINGS_H
+
+#include <access/Path.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pugi {
+class xml_document;
+class xml_node;
+} // namespace pugi
+
+namespace odr::access {
+class ReadStorage;
+}
+
+namespace odr::common {
+class HtmlWriter;
+}
+
+namespace odr::ooxml {
+
+// shared strings of a workbook. the part is scanned into an offset table on
+// first use; a string is parsed only when it is referenced and its html is
+// kept once rendered.
+class SharedStrings final {
+public:
+  using Renderer = std::function<void(pugi::xml_node, common::HtmlWriter &)>;
+
+  SharedStrings(const access::ReadStorage &storage, access::Path path);
+
+  std::uint32_t size();
+  // parses the `si` element at `index`
+  pugi::xml_document get(std::uint32_t index);
+  // html of the string at `index`, rendered from its `si` element on first use
+  const std::string &html(std::uint32_t index, const Renderer &renderer);
+
+private:
+  struct Range {
+    std::uint64_t offset;
+    std::uint32_t size;
+  };
+
+  const access::ReadStorage &storage_;
+  const access::Path path_;
+  bool scanned_{false};
+  std::string xml_;
+  std::vector<Range> ranges_;
+  std::unordered_map<std::uint32_t, std::string> html_;
+
+  void scan_();
+};
+
+} // namespace odr::ooxml
+
+#endif // ODR_OOXML_SHARED_STRINGS_H
@@ -1,22 +1,25 @@
 #include <Context.h>
+#include <SharedStrings.h>
 #include <WorkbookTranslator.h>
 #include <access/Storage.h>
 #include <access/StreamUtil.h>
-#include <common/StringUtil.h>
+#include <algorithm>
+#include <common/HtmlWriter.h>
+#include <common/NameTable.h>
+#include <common/XmlPullParser.h>
 #include <common/XmlUtil.h>
+#include <cstdlib>
 #include <cstring>
 #include <glog/logging.h>
 #include <odr/Config.h>
 #include <odr/Meta.h>
 #include <pugixml.hpp>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
 
 namespace odr::ooxml {
 
 namespace {
-void FontsTranslator(pugi::xml_node in, std::ostream &out, Context &) {
+void FontsTranslator(pugi::xml_node in, common::HtmlWriter &out, Context &) {
   std::uint32_t i = 0;
   for (auto &&e : in.children()) {
     out << ".font-" << i << " {";
@@ -42,7 +45,7 @@ void FontsTranslator(pugi::xml_node in, std::ostream &out, Context &) {
   }
 }
 
-void FillsTranslator(pugi::xml_node in, std::ostream &out, Context &) {
+void FillsTranslator(pugi::xml_node in, common::HtmlWriter &out, Context &) {
   std::uint32_t i = 0;
   for (auto &&e : in.children()) {
     out << ".fill-" << i << " {";
@@ -60,7 +63,7 @@ void FillsTranslator(pugi::xml_node in, std::ostream &out, Context &) {
   }
 }
 
-void BordersTranslator(pugi::xml_node in, std::ostream &out, Context &) {
+void BordersTranslator(pugi::xml_node in, common::HtmlWriter &out, Context &) {
   std::uint32_t i = 0;
   for (auto &&e : in.children()) {
     out << ".border-" << i << " {";
@@ -71,7 +74,8 @@ void BordersTranslator(pugi::xml_node in, std::ostream &out, Context &) {
   }
 }
 
-void CellXfsTranslator(pugi::xml_node in, std::ostream &out, Context &context) {
+void CellXfsTranslator(pugi::xml_node in, common::HtmlWriter &out,
+                       Context &context) {
   std::uint32_t i = 0;
   for (auto &&e : in.children()) {
     const std::string name = "cellxf-" + std::to_string(i);
@@ -116,7 +120,7 @@ void CellXfsTranslator(pugi::xml_node in, std::ostream &out, Context &context) {
 } // namespace
 
 void WorkbookTranslator::css(pugi::xml_node in, Context &context) {
-  std::ostream &out = *context.output;
+  common::HtmlWriter &out = *context.output;
 
   if (const auto fonts = in.child("fonts"); fonts)
     FontsTranslator(fonts, out, context);
@@ -132,23 +136,22 @@ void WorkbookTranslator::css(pugi::xml_node in, Context &context) {
 }
 
 namespace {
-void TextTranslator(pugi::xml_node in, std::ostream &out, Context &context) {
-  std::string text = in.value();
-  common::StringUtil::findAndReplaceAll(text, "&", "&amp;");
-  common::StringUtil::findAndReplaceAll(text, "<", "&lt;");
-  common::StringUtil::findAndReplaceAll(text, ">", "&gt;");
-
+void TextTranslator(pugi::xml_node in, common::HtmlWriter &out,
+                    Context &context) {
   if (!context.config->editable) {
-    out << text;
+    out.text(in.value());
   } else {
     out << R"(<span contenteditable="true" data-odr-cid=")"
-        << context.currentTextTranslationIndex << "\">" << text << "</span>";
+        << context.currentTextTranslationIndex << "\">";
+    out.text(in.value());
+    out << "</span>";
     context.textTranslation[context.currentTextTranslationIndex] = in;
     ++context.currentTextTranslationIndex;
   }
 }
 
-void StyleAttributeTranslator(pugi::xml_node in, std::ostream &out, Context &) {
+void StyleAttributeTranslator(pugi::xml_node in, common::HtmlWriter &out,
+                              Context &) {
   const std::string prefix = in.name();
 
   const auto width = in.attribute("width");
@@ -163,51 +166,71 @@ void StyleAttributeTranslator(pugi::xml_node in, std::ostream &out, Context &) {
   }
 }
 
-void ElementAttributeTranslator(pugi::xml_node in, std::ostream &out,
+void ElementAttributeTranslator(pugi::xml_node in, common::HtmlWriter &out,
                                 Context &context) {
   if (const auto s = in.attribute("s"); s) {
     const std::string name = std::string("cellxf-") + s.as_string();
     out << " class=\"";
-    out << name;
-
-    { // handle style dependencies
-      const auto it = context.styleDependencies.find(name);
-      if (it == context.styleDependencies.end()) {
-        // TODO remove ?
-        LOG(WARNING) << "unknown style: " << name;
-      } else {
-        for (auto i = it->second.rbegin(); i != it->second.rend(); ++i) {
-          out << " " << *i;
-        }
-      }
-    }
-
+    context.styleClasses.write(name, out);
     out << "\"";
   }
 
   StyleAttributeTranslator(in, out, context);
 }
 
-void ElementChildrenTranslator(pugi::xml_node in, std::ostream &out,
+void ElementChildrenTranslator(pugi::xml_node in, common::HtmlWriter &out,
                                Context &context);
-void ElementTranslator(pugi::xml_node in, std::ostream &out, Context &context);
+void ElementTranslator(pugi::xml_node in, common::HtmlWriter &out,
+                       Context &context);
+
+// one based `r` of the current row element; zero if there is none
+std::uint32_t rowNumber(const common::XmlPullParser &parser) {
+  const char *r = parser.attribute("r");
+  if (r == nullptr)
+    return 0;
+  return std::strtoul(r, nullptr, 10);
+}
 
-void TableTranslator(pugi::xml_node in, std::ostream &out, Context &context) {
-  // TODO context.config->tableLimitByDimensions
+void TableBeginTranslator(pugi::xml_node in, common::HtmlWriter &out,
+                          Context &context) {
   context.tableRange = {
       {context.config->tableOffsetRows, context.config->tableOffsetCols},
       context.config->tableLimitRows,
       context.config->tableLimitCols};
+
+  // dimensions are unknown for worksheets without `dimension`
+  if (context.config->tableLimitByDimensions &&
+      (context.entry < context.meta->entries.size()) &&
+      (context.meta->entries[context.entry].rowCount > 0)) {
+    // the limits count from the offset, the dimensions from the origin
+    const common::TablePosition end{
+        std::min(context.tableRange.to().row(),
+                 context.meta->entries[context.entry].rowCount),
+        std::min(context.tableRange.to().col(),
+                 context.meta->entries[context.entry].columnCount)};
+
+    context.tableRange = {context.tableRange.from(), end};
+  }
+
   context.tableCursor = {};
 
   out << R"(<table border="0" cellspacing="0" cellpadding="0")";
   ElementAttributeTranslator(in, out, context);
   out << ">";
-  ElementChildrenTranslator(in, out, context);
+}
+
+void TableEndTranslator(common::HtmlWriter &out, Context &) {
   out << "</table>";
 }
 
-void TableColTranslator(pugi::xml_node in, std::ostream &out,
+void TableTranslator(pugi::xml_node in, common::HtmlWriter &out,
+                     Context &context) {
+  TableBeginTranslator(in, out, context);
+  ElementChildrenTranslator(in, out, context);
+  TableEndTranslator(out, context);
+}
+
+void TableColTranslator(pugi::xml_node in, common::HtmlWriter &out,
                         Context &context) {
   // TODO if min/max is unordered we have a problem here; fail fast in that case
 
@@ -227,10 +250,15 @@ void TableColTranslator(pugi::xml_node in, std::ostream &out,
   }
 }
 
-void TableRowTranslator(pugi::xml_node in, std::ostream &out,
+void TableRowTranslator(pugi::xml_node in, common::HtmlWriter &out,
                         Context &context) {
   const auto rowIndex = in.attribute("r").as_uint() - 1;
 
+  // empty rows before the table range produce no output
+  const auto skipTo = std::min(rowIndex, context.tableRange.from().row());
+  if (skipTo > context.tableCursor.row())
+    context.tableCursor.addRow(skipTo - context.tableCursor.row());
+
   while (rowIndex > context.tableCursor.row()) {
     if (context.tableCursor.row() >= context.tableRange.to().row())
       return;
@@ -254,10 +282,16 @@ void TableRowTranslator(pugi::xml_node in, std::ostream &out,
   context.tableCursor.addRow();
 }
 
-void TableCellTranslator(pugi::xml_node in, std::ostream &out,
+void TableCellTranslator(pugi::xml_node in, common::HtmlWriter &out,
                          Context &context) {
   const common::TablePosition cellIndex(in.attribute("r").as_string());
 
+  // empty cells before the table range produce no output
+  const auto skipTo =
+      std::min(cellIndex.col(), context.tableRange.from().col());
+  if (skipTo > context.tableCursor.col())
+    context.tableCursor.addCell(1, 1, skipTo - context.tableCursor.col());
+
   while (cellIndex.col() > context.tableCursor.col()) {
     if (context.tableCursor.col() >= context.tableRange.to().col())
       return;
@@ -274,9 +308,21 @@ void TableCellTranslator(pugi::xml_node in, std::ostream &out,
   if (const auto t = in.attribute("t"); t) {
     if (std::strcmp(t.as_string(), "s") == 0) {
       const auto sharedStringIndex = in.child("v").text().as_int(-1);
-      if (sharedStringIndex >= 0) {
-        pugi::xml_node replacement = context.sharedStrings[sharedStringIndex];
-        ElementChildrenTranslator(replacement, out, context);
+      if ((sharedStringIndex >= 0) && (context.sharedStrings != nullptr) &&
+          (static_cast<std::uint32_t>(sharedStringIndex) <
+           context.sharedStrings->size())) {
+        if (context.config->editable) {
+          // every occurrence gets its own text ids
+          const auto replacement =
+              context.sharedStrings->get(sharedStringIndex);
+          ElementChildrenTranslator(replacement.document_element(), out,
+                                    context);
+        } else {
+          out << context.sharedStrings->html(
+              sharedStringIndex, [&](pugi::xml_node si, common::HtmlWriter &o) {
+                ElementChildrenTranslator(si, o, context);
+              });
+        }
       } else {
         DLOG(INFO) << "undefined behaviour: shared string not found";
       }
@@ -295,7 +341,7 @@ void TableCellTranslator(pugi::xml_node in, std::ostream &out,
   context.tableCursor.addCell();
 }
 
-void ElementChildrenTranslator(pugi::xml_node in, std::ostream &out,
+void ElementChildrenTranslator(pugi::xml_node in, common::HtmlWriter &out,
                                Context &context) {
   for (auto &&n : in) {
     if (n.type() == pugi::node_pcdata)
@@ -305,39 +351,65 @@ void ElementChildrenTranslator(pugi::xml_node in, std::ostream &out,
   }
 }
 
-void ElementTranslator(pugi::xml_node in, std::ostream &out, Context &context) {
-  static std::unordered_map<std::string, const char *> substitution{
-      {"cols", "colgroup"},
-  };
-  static std::unordered_set<std::string> skippers{
-      "headerFooter",
-      "f", // TODO translate formula and hide
-  };
-
-  const std::string element = in.name();
-  if (skippers.find(element) != skippers.end())
+enum class Element {
+  UNKNOWN,
+  SKIP,
+  TABLE,
+  TABLE_COLUMN,
+  TABLE_ROW,
+  TABLE_CELL,
+  // substituted by a plain html element
+  TABLE_COLUMNS,
+};
+
+constexpr auto elements = common::nameTable<Element>({
+    {"worksheet", Element::TABLE},
+    {"col", Element::TABLE_COLUMN},
+    {"row", Element::TABLE_ROW},
+    {"c", Element::TABLE_CELL},
+    {"cols", Element::TABLE_COLUMNS},
+    // parts of a worksheet after `sheetData` must not produce output, see
+    // `WorkbookTranslator::html(common::XmlPullParser &, Context &)`
+    {"headerFooter", Element::SKIP},
+    {"conditionalFormatting", Element::SKIP},
+    {"dataValidations", Element::SKIP},
+    {"extLst", Element::SKIP},
+    {"f", Element::SKIP}, // TODO translate formula and hide
+});
+
+void ElementTranslator(pugi::xml_node in, common::HtmlWriter &out,
+                       Context &context) {
+  const char *substitution = nullptr;
+  switch (elements.find(in.name(), Element::UNKNOWN)) {
+  case Element::SKIP:
     return;
-
-  if (element == "worksheet")
+  case Element::TABLE:
     TableTranslator(in, out, context);
-  else if (element == "col")
+    return;
+  case Element::TABLE_COLUMN:
     TableColTranslator(in, out, context);
-  else if (element == "row")
+    return;
+  case Element::TABLE_ROW:
     TableRowTranslator(in, out, context);
-  else if (element == "c")
+    return;
+  case Element::TABLE_CELL:
     TableCellTranslator(in, out, context);
-  else {
-    const auto it = substitution.find(element);
-    if (it != substitution.end()) {
-      out << "<" << it->second;
-      ElementAttributeTranslator(in, out, context);
-      out << ">";
-    }
-    ElementChildrenTranslator(in, out, context);
-    if (it != substitution.end()) {
-      out << "</" << it->second << ">";
-    }
+    return;
+  case Element::TABLE_COLUMNS:
+    substitution = "colgroup";
+    break;
+  case Element::UNKNOWN:
+    break;
+  }
+
+  if (substitution != nullptr) {
+    out << "<" << substitution;
+    ElementAttributeTranslator(in, out, context);
+    out << ">";
   }
+  ElementChildrenTranslator(in, out, context);
+  if (substitution != nullptr)
+    out << "</" << substitution << ">";
 }
 } // namespace
 
@@ -345,4 +417,93 @@ void WorkbookTranslator::html(pugi::xml_node in, Context &context) {
   ElementTranslator(in, *context.output, context);
 }
 
+common::TableRowIndex
+WorkbookTranslator::indexRows(common::XmlPullParser &parser) {
+  using Event = common::XmlPullParser::Event;
+
+  common::TableRowIndex result;
+  std::uint32_t row = 0;
+  while (true) {
+    switch (parser.next()) {
+    case Event::START_ELEMENT:
+      if (parser.depth() == 1) {
+        break;
+      } else if ((parser.depth() == 2) && (parser.name() == "sheetData")) {
+        break;
+      } else if ((parser.depth() == 3) && (parser.name() == "row")) {
+        if (rowNumber(parser) > 0)
+          row = rowNumber(parser) - 1;
+        result.add(row, parser.offset());
+        ++row;
+      }
+      parser.skip();
+      break;
+    case Event::END_DOCUMENT:
+      return result;
+    default:
+      break;
+    }
+  }
+}
+
+void WorkbookTranslator::html(common::XmlPullParser &parser,
+                              Context &context) {
+  using Event = common::XmlPullParser::Event;
+  common::HtmlWriter &out = *context.output;
+
+  pugi::xml_document worksheet;
+  TableBeginTranslator(parser.append(worksheet), out, context);
+
+  bool done = false;
+  while (!done) {
+    switch (parser.next()) {
+    case Event::START_ELEMENT:
+      if (parser.name() != "sheetData") {
+        pugi::xml_document fragment;
+        ElementTranslator(parser.copy(fragment), out, context);
+        break;
+      }
+      // nothing after the rows produces output; stop reading after the last
+      // row within the table range
+      while (!done) {
+        switch (parser.next()) {
+        case Event::START_ELEMENT:
+          if (context.tableCursor.row() >= context.tableRange.to().row()) {
+            done = true;
+          } else if (const auto r = rowNumber(parser);
+                     (r > 0) && (r <= context.tableRange.from().row())) {
+            // rows before the table range produce no output
+            parser.skip();
+          } else {
+            pugi::xml_document fragment;
+            ElementTranslator(parser.copy(fragment), out, context);
+          }
+          break;
+        case Event::END_ELEMENT:
+        case Event::END_DOCUMENT:
+          done = true;
+          break;
+        default:
+          break;
+        }
+      }
+      break;
+    case Event::TEXT: {
+      pugi::xml_document fragment;
+      fragment.append_child(pugi::node_pcdata)
+          .set_value(parser.text().c_str());
+      ElementChildrenTranslator(fragment, out, context);
+    } break;
+    case Event::END_ELEMENT:
+    case Event::END_DOCUMENT:
+      done = true;
+      break;
+    default:
+      break;
+    }
+  }
+
+  TableEndTranslator(out, context);
+}
+
 } // namespace odr::ooxml
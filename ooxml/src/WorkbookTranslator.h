@@ -1,12 +1,17 @@
 #ifndef ODR_OOXML_WORKBOOK_TRANSLATOR_H
 #define ODR_OOXML_WORKBOOK_TRANSLATOR_H
 
+#include <common/TableRowIndex.h>
 #include <memory>
 
 namespace pugi {
 class xml_node;
 }
 
+namespace odr::common {
+class XmlPullParser;
+}
+
 namespace odr::ooxml {
 
 struct Context;
@@ -14,6 +19,11 @@ struct Context;
 namespace WorkbookTranslator {
 void css(pugi::xml_node in, Context &context);
 void html(pugi::xml_node in, Context &context);
+// reads the worksheet row by row from `parser`, which is positioned at the
+// start of `worksheet`, and stops at the end of the table range
+void html(common::XmlPullParser &parser, Context &context);
+// scans a whole worksheet without building any DOM
+common::TableRowIndex indexRows(common::XmlPullParser &parser);
 } // namespace WorkbookTranslator
 
 } // namespace odr::ooxml
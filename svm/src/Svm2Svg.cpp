@@ -1,4 +1,5 @@
 #include <codecvt>
+#include <common/HtmlWriter.h>
 #include <cstring>
 #include <glog/logging.h>
 #include <locale>
@@ -504,7 +505,7 @@ struct TextLineAction final {
 
 struct SvmContext final {
   std::istream *in{};
-  std::ostream *out{};
+  common::HtmlWriter *out{};
   const ActionHeader *action{};
 
   MapMode mapMode;
@@ -529,7 +530,7 @@ std::string getSVGColorString(const std::uint32_t color) {
          std::to_string(blue) + ")";
 }
 
-void writeColorStyle(std::ostream &out, const std::string &prefix,
+void writeColorStyle(common::HtmlWriter &out, const std::string &prefix,
                      const std::uint32_t color, const bool set) {
   if (set) {
     out << prefix << ":" << getSVGColorString(color);
@@ -539,24 +540,25 @@ void writeColorStyle(std::ostream &out, const std::string &prefix,
   out << ";";
 }
 
-void writeLineStyle(std::ostream &out, SvmContext &context) {
+void writeLineStyle(common::HtmlWriter &out, SvmContext &context) {
   writeColorStyle(out, "stroke", context.lineRGB, context.lineRGBSet);
   out << "vector-effect:non-scaling-stroke;";
   out << "fill:none;";
 }
 
-void writeFillStyle(std::ostream &out, SvmContext &context) {
+void writeFillStyle(common::HtmlWriter &out, SvmContext &context) {
   writeColorStyle(out, "fill", context.fillRGB, context.fillRGBSet);
   out << "stroke:none;";
 }
 
-void writeTextStyle(std::ostream &out, SvmContext &context) {
+void writeTextStyle(common::HtmlWriter &out, SvmContext &context) {
   writeColorStyle(out, "fill", context.textRGB, true);
   out << "font-family:" << context.font.familyName << ";";
   out << "font-size:" << context.font.size.y << ";";
 }
 
-void writeStyle(std::ostream &out, SvmContext &context, const int styles) {
+void writeStyle(common::HtmlWriter &out, SvmContext &context,
+                const int styles) {
   out << " style=\"";
   switch (styles) {
   case 0:
@@ -575,7 +577,7 @@ void writeStyle(std::ostream &out, SvmContext &context, const int styles) {
   out << "\"";
 }
 
-void writeRectangle(std::ostream &out, const Rectangle &rect,
+void writeRectangle(common::HtmlWriter &out, const Rectangle &rect,
                     SvmContext &context) {
   out << "<rect";
   out << " x=\"" << rect.left << "\"";
@@ -586,7 +588,7 @@ void writeRectangle(std::ostream &out, const Rectangle &rect,
   out << " />";
 }
 
-void writePolygon(std::ostream &out, const std::string &tag,
+void writePolygon(common::HtmlWriter &out, const std::string &tag,
                   const std::vector<IntPair> &points, const bool fill,
                   SvmContext &context) {
   out << "<" << tag;
@@ -607,8 +609,8 @@ void writePolygon(std::ostream &out, const std::string &tag,
   out << " />";
 }
 
-void writeText(std::ostream &out, const IntPair &point, const std::string &text,
-               SvmContext &context) {
+void writeText(common::HtmlWriter &out, const IntPair &point,
+               const std::string &text, SvmContext &context) {
   out << "<text";
   out << " x=\"" << point.x << "\"";
   out << " y=\"" << point.y << "\"";
@@ -619,7 +621,7 @@ void writeText(std::ostream &out, const IntPair &point, const std::string &text,
 }
 
 void translateAction(const ActionHeader &action, std::istream &in,
-                     std::ostream &out, SvmContext &context) {
+                     common::HtmlWriter &out, SvmContext &context) {
   switch (action.type) {
   case META_FILLCOLOR_ACTION:
     readPrimitive(in, context.fillRGB);
@@ -705,7 +707,8 @@ void translateAction(const ActionHeader &action, std::istream &in,
 }
 } // namespace
 
-void Translator::svg(std::istream &in, std::ostream &out) {
+void Translator::svg(std::istream &in, std::ostream &sink) {
+  common::HtmlWriter out(sink);
   SvmContext context{};
   context.in = &in;
   context.out = &out;
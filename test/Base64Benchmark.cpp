@@ -0,0 +1,54 @@
+#include <base64.h>
+#include <chrono>
+#include <common/HtmlWriter.h>
+#include <crypto/Base64.h>
+#include <cstdint>
+#include <filters.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace odr;
+
+namespace {
+template <typename Run> double measure(Run run) {
+  const auto begin = std::chrono::steady_clock::now();
+  run();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+} // namespace
+
+// compares inlining an image through the CryptoPP encoder with
+// `common::HtmlWriter::base64`. takes the size in MiB and writes to /dev/null
+// so that only the encoding cost is measured.
+int main(int argc, char **argv) {
+  const std::uint32_t mebibytes = argc > 1 ? std::stoul(argv[1]) : 64;
+  std::string image(mebibytes * 1024 * 1024, '\0');
+  for (std::size_t i = 0; i < image.size(); ++i)
+    image[i] = static_cast<char>(i * 2654435761u >> 13);
+  std::ofstream sink("/dev/null");
+
+  const double cryptopp = measure([&]() {
+    std::string encoded;
+    CryptoPP::Base64Encoder encoder(new CryptoPP::StringSink(encoded), false);
+    encoder.Put(reinterpret_cast<const CryptoPP::byte *>(image.data()),
+                image.size());
+    encoder.MessageEnd();
+    common::HtmlWriter out(sink);
+    out << encoded;
+  });
+  const double writer = measure([&]() {
+    std::istringstream in(image);
+    common::HtmlWriter out(sink);
+    out.base64(in);
+  });
+
+  std::cout << mebibytes << " MiB" << std::endl;
+  std::cout << "CryptoPP:                   " << cryptopp << " ms, "
+            << mebibytes * 1000.0 / cryptopp << " MiB/s" << std::endl;
+  std::cout << "common::HtmlWriter::base64: " << writer << " ms, "
+            << mebibytes * 1000.0 / writer << " MiB/s" << std::endl;
+  std::cout << "speedup:                    " << cryptopp / writer << std::endl;
+}
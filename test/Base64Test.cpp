@@ -0,0 +1,67 @@
+#include <crypto/Base64.h>
+#include <crypto/src/Base64Encoders.h>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace odr;
+
+TEST(Base64, encode) {
+  EXPECT_EQ("", crypto::Base64::encode(""));
+  EXPECT_EQ("Zg==", crypto::Base64::encode("f"));
+  EXPECT_EQ("Zm8=", crypto::Base64::encode("fo"));
+  EXPECT_EQ("Zm9v", crypto::Base64::encode("foo"));
+  EXPECT_EQ("Zm9vYmFy", crypto::Base64::encode("foobar"));
+  EXPECT_EQ("+/+/", crypto::Base64::encode("\xfb\xff\xbf"));
+  // wide enough for the vectorized paths
+  EXPECT_EQ("VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4=",
+            crypto::Base64::encode(
+                "The quick brown fox jumps over the lazy dog."));
+}
+
+TEST(Base64, decode) {
+  EXPECT_EQ("foobar", crypto::Base64::decode("Zm9vYmFy"));
+  EXPECT_EQ("fo", crypto::Base64::decode("Zm8="));
+  EXPECT_EQ("f", crypto::Base64::decode("Zg=="));
+  // line breaks and other characters outside of the alphabet are skipped
+  EXPECT_EQ("foobar", crypto::Base64::decode("Zm9v\r\nYm Fy\n"));
+}
+
+TEST(Base64, roundtrip) {
+  // every length around the block sizes of the vectorized paths
+  for (std::size_t size = 0; size < 100; ++size) {
+    std::string data(size, '\0');
+    for (std::size_t i = 0; i < size; ++i)
+      data[i] = static_cast<char>(i * 37 + size);
+    const std::string encoded = crypto::Base64::encode(data);
+    EXPECT_EQ(crypto::Base64::encodedSize(size), encoded.size());
+    EXPECT_EQ(data, crypto::Base64::decode(encoded)) << size;
+  }
+}
+
+TEST(Base64, encoders) {
+  const auto &encoders = crypto::Base64::encoders();
+  ASSERT_NE(nullptr, encoders.scalar);
+  // lengths around the block sizes, offsets and a tail of every length
+  std::string data(300, '\0');
+  for (std::size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i * 131 + 7);
+  const auto in = reinterpret_cast<const std::uint8_t *>(data.data());
+  for (auto &&encoder : {encoders.ssse3, encoders.avx2}) {
+    if (encoder == nullptr)
+      continue;
+    for (std::size_t size = 0; size <= data.size(); ++size) {
+      for (std::size_t pos : {0, 3}) {
+        if (pos > size)
+          continue;
+        const std::size_t encodedSize =
+            crypto::Base64::encodedSize(size - pos);
+        std::string expected(encodedSize, '\0');
+        std::string actual(encodedSize, '\0');
+        encoders.scalar(in, pos, size, expected.data());
+        encoder(in, pos, size, actual.data());
+        EXPECT_EQ(expected, actual) << size << " " << pos;
+      }
+    }
+  }
+}
@@ -1,12 +1,19 @@
 #include <access/Path.h>
+#include <algorithm>
+#include <cctype>
+#include <common/StyleSheet.h>
 #include <csv.hpp>
 #include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <iterator>
 #include <map>
 #include <nlohmann/json.hpp>
 #include <odr/Config.h>
 #include <odr/Document.h>
 #include <odr/Meta.h>
+#include <sstream>
+#include <unordered_set>
 #include <utility>
 
 using namespace odr;
@@ -220,5 +227,222 @@ TEST_P(DataDrivenTest, all) {
   }
 }
 
+TEST_P(DataDrivenTest, streaming) {
+  const auto param = GetParam();
+
+  if ((param.type != FileType::OPENDOCUMENT_TEXT) &&
+      (param.type != FileType::OPENDOCUMENT_PRESENTATION) &&
+      (param.type != FileType::OPENDOCUMENT_SPREADSHEET) &&
+      (param.type != FileType::OPENDOCUMENT_GRAPHICS) &&
+      (param.type != FileType::OFFICE_OPEN_XML_WORKBOOK))
+    GTEST_SKIP();
+
+  const odr::Document document{param.input};
+  if (document.encrypted() && !document.decrypt(param.password))
+    GTEST_SKIP();
+
+  const auto read = [](const std::string &path) {
+    std::ifstream in(path);
+    return std::string(std::istreambuf_iterator<char>(in), {});
+  };
+
+  fs::create_directories(fs::path(param.output));
+  const std::string domOutput = param.output + "/dom.html";
+  const std::string streamOutput = param.output + "/stream.html";
+  const std::string tokenOutput = param.output + "/token.html";
+
+  odr::Config config;
+  config.tableLimitRows = 4000;
+  config.tableLimitCols = 500;
+  // whole document and first entry only
+  for (std::uint32_t count : {0, 1}) {
+    config.entryCount = count;
+    config.streaming = false;
+    document.translate(domOutput, config);
+    config.streaming = true;
+    document.translate(streamOutput, config);
+    EXPECT_EQ(read(domOutput), read(streamOutput));
+    // the token tree only replaces pugixml for OpenDocument
+    config.streaming = false;
+    config.tokenDom = true;
+    document.translate(tokenOutput, config);
+    config.tokenDom = false;
+    EXPECT_EQ(read(domOutput), read(tokenOutput));
+  }
+}
+
+TEST_P(DataDrivenTest, rowWindow) {
+  const auto param = GetParam();
+
+  if ((param.type != FileType::OPENDOCUMENT_SPREADSHEET) &&
+      (param.type != FileType::OFFICE_OPEN_XML_WORKBOOK))
+    GTEST_SKIP();
+
+  const odr::Document document{param.input};
+  if (document.encrypted() && !document.decrypt(param.password))
+    GTEST_SKIP();
+
+  const auto read = [](const std::string &path) {
+    std::ifstream in(path);
+    return std::string(std::istreambuf_iterator<char>(in), {});
+  };
+
+  fs::create_directories(fs::path(param.output));
+  const std::string domOutput = param.output + "/dom-window.html";
+  const std::string streamOutput = param.output + "/stream-window.html";
+
+  odr::Config config;
+  config.tableLimitRows = 4000;
+  config.tableLimitCols = 500;
+  // past the first row mark with the default stride of 1024, so streaming
+  // resumes from a mark instead of reading the rows in between
+  config.tableOffsetRows = 1500;
+  const auto compare = [&] {
+    config.streaming = false;
+    document.translate(domOutput, config);
+    config.streaming = true;
+    document.translate(streamOutput, config);
+    EXPECT_EQ(read(domOutput), read(streamOutput));
+  };
+
+  // whole document and every sheet on its own, which reads OpenDocument
+  // sheets from their indexed range
+  compare();
+  const auto meta = document.meta();
+  for (std::uint32_t i = 0; i < meta.entryCount; ++i) {
+    config.entryOffset = i;
+    config.entryCount = 1;
+    compare();
+  }
+}
+
+TEST_P(DataDrivenTest, pruneStyles) {
+  const auto param = GetParam();
+
+  if ((param.type != FileType::OPENDOCUMENT_TEXT) &&
+      (param.type != FileType::OPENDOCUMENT_PRESENTATION) &&
+      (param.type != FileType::OPENDOCUMENT_SPREADSHEET) &&
+      (param.type != FileType::OPENDOCUMENT_GRAPHICS) &&
+      (param.type != FileType::OFFICE_OPEN_XML_WORKBOOK))
+    GTEST_SKIP();
+
+  const odr::Document document{param.input};
+  if (document.encrypted() && !document.decrypt(param.password))
+    GTEST_SKIP();
+
+  // css and the rest of the html
+  const auto read = [](const std::string &path) {
+    std::ifstream in(path);
+    const std::string html(std::istreambuf_iterator<char>(in), {});
+    const auto begin = html.find("<style>") + 7;
+    const auto end = html.find("</style>", begin);
+    return std::make_pair(html.substr(begin, end - begin),
+                          html.substr(0, begin) + html.substr(end));
+  };
+  const auto usedClasses = [](const std::string &html) {
+    std::unordered_set<std::string> result;
+    for (auto it = html.find("class=\""); it != std::string::npos;
+         it = html.find("class=\"", it)) {
+      it += 7;
+      const auto end = html.find('"', it);
+      std::istringstream names(html.substr(it, end - it));
+      for (std::string name; names >> name;)
+        result.insert(name);
+    }
+    return result;
+  };
+
+  fs::create_directories(fs::path(param.output));
+  const std::string fullOutput = param.output + "/full.html";
+  const std::string prunedOutput = param.output + "/pruned.html";
+
+  odr::Config config;
+  config.tableLimitRows = 4000;
+  config.tableLimitCols = 500;
+  // whole document and first entry only
+  for (std::uint32_t count : {0, 1}) {
+    config.entryCount = count;
+    config.pruneStyles = false;
+    document.translate(fullOutput, config);
+    config.pruneStyles = true;
+    document.translate(prunedOutput, config);
+    const auto full = read(fullOutput);
+    const auto pruned = read(prunedOutput);
+    EXPECT_EQ(full.second, pruned.second);
+    // every rule that can match the content is still there
+    const auto used = usedClasses(pruned.second);
+    for (auto &&rule : common::StyleSheet::rules(full.first)) {
+      const auto names = common::StyleSheet::classes(rule.selector);
+      if (names.empty() ||
+          std::any_of(names.begin(), names.end(), [&](const auto name) {
+            return used.find(std::string(name)) != used.end();
+          }))
+        EXPECT_NE(std::string::npos, pruned.first.find(rule.text))
+            << rule.text;
+    }
+  }
+}
+
+TEST_P(DataDrivenTest, flattenStyles) {
+  const auto param = GetParam();
+
+  if ((param.type != FileType::OPENDOCUMENT_TEXT) &&
+      (param.type != FileType::OPENDOCUMENT_PRESENTATION) &&
+      (param.type != FileType::OPENDOCUMENT_SPREADSHEET) &&
+      (param.type != FileType::OPENDOCUMENT_GRAPHICS) &&
+      (param.type != FileType::OFFICE_OPEN_XML_WORKBOOK))
+    GTEST_SKIP();
+
+  const odr::Document document{param.input};
+  if (document.encrypted() && !document.decrypt(param.password))
+    GTEST_SKIP();
+
+  // css and the rest of the html without class attributes
+  const auto read = [](const std::string &path) {
+    std::ifstream in(path);
+    const std::string html(std::istreambuf_iterator<char>(in), {});
+    const auto begin = html.find("<style>") + 7;
+    const auto end = html.find("</style>", begin);
+    std::string rest = html.substr(0, begin) + html.substr(end);
+    for (auto it = rest.find(" class=\""); it != std::string::npos;
+         it = rest.find(" class=\"", it))
+      rest.erase(it, rest.find('"', it + 8) + 1 - it);
+    return std::make_pair(html.substr(begin, end - begin), rest);
+  };
+
+  fs::create_directories(fs::path(param.output));
+  const std::string plainOutput = param.output + "/plain.html";
+  const std::string flatOutput = param.output + "/flat.html";
+
+  odr::Config config;
+  config.tableLimitRows = 4000;
+  config.tableLimitCols = 500;
+  for (bool prune : {false, true}) {
+    config.pruneStyles = prune;
+    config.flattenStyles = false;
+    document.translate(plainOutput, config);
+    config.flattenStyles = true;
+    document.translate(flatOutput, config);
+    const auto plain = read(plainOutput);
+    const auto flat = read(flatOutput);
+    EXPECT_EQ(plain.second, flat.second);
+
+    // every generated class the content uses is defined
+    std::ifstream in(flatOutput);
+    const std::string html(std::istreambuf_iterator<char>(in), {});
+    for (auto it = html.find("odr-s", html.find("</style>"));
+         it != std::string::npos; it = html.find("odr-s", it + 1)) {
+      auto end = it + 5;
+      while (std::isdigit(static_cast<unsigned char>(html[end])))
+        ++end;
+      const std::string name = html.substr(it, end - it);
+      EXPECT_TRUE((flat.first.find("." + name + " {") != std::string::npos) ||
+                  (flat.first.find("." + name + "." + name + " {") !=
+                   std::string::npos))
+          << name;
+    }
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(all, DataDrivenTest,
                         testing::ValuesIn(getTestParams()));
@@ -0,0 +1,52 @@
+#include <chrono>
+#include <common/HtmlWriter.h>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace odr;
+
+namespace {
+// shaped like the cells `WorkbookTranslator` and `ContentTranslator` emit
+template <typename Out> void table(Out &out, const std::uint32_t rows) {
+  for (std::uint32_t row = 0; row < rows; ++row) {
+    out << "<tr style=\"height:" << 0.17 * (row % 7 + 1) << "in;\">";
+    for (std::uint32_t column = 0; column < 16; ++column) {
+      out << "<td class=\"cell-" << column << "\"";
+      out << " style=\"width:" << 0.85 + column * 0.01 << "in;\">";
+      out << "<span>" << row * column << "</span>";
+      out << "</td>";
+    }
+    out << "</tr>";
+  }
+}
+
+template <typename Run> double measure(Run run) {
+  const auto begin = std::chrono::steady_clock::now();
+  run();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+} // namespace
+
+// compares the translator output path before and after `HtmlWriter`. writes
+// to /dev/null so that only the formatting cost is measured.
+int main(int argc, char **argv) {
+  const std::uint32_t rows = argc > 1 ? std::stoul(argv[1]) : 100000;
+  std::ofstream sink("/dev/null");
+
+  const double ostream = measure([&]() {
+    table(sink, rows);
+    sink.flush();
+  });
+  const double writer = measure([&]() {
+    common::HtmlWriter out(sink);
+    table(out, rows);
+  });
+
+  std::cout << rows << " rows" << std::endl;
+  std::cout << "std::ostream:       " << ostream << " ms" << std::endl;
+  std::cout << "common::HtmlWriter: " << writer << " ms" << std::endl;
+  std::cout << "speedup:            " << ostream / writer << std::endl;
+}
@@ -0,0 +1,92 @@
+#include <common/HtmlWriter.h>
+#include <crypto/Base64.h>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace odr;
+
+TEST(HtmlWriter, numbers) {
+  // has to look exactly like the `std::ostream` output it replaces
+  for (const double value :
+       {0.0, -0.0, 0.5, 1e-5, 123456.0, 1234567.0, 3.14159265, -2.54, 1e100}) {
+    common::HtmlWriter writer;
+    writer << value << ' ' << static_cast<float>(value);
+    std::ostringstream expected;
+    expected << value << ' ' << static_cast<float>(value);
+    EXPECT_EQ(expected.str(), writer.str());
+  }
+
+  common::HtmlWriter writer;
+  writer << 0 << ' ' << -42 << ' ' << std::uint32_t{4000000000u} << ' '
+         << std::int64_t{-9000000000000000000} << ' ' << true;
+  EXPECT_EQ("0 -42 4000000000 -9000000000000000000 1", writer.str());
+}
+
+TEST(HtmlWriter, escape) {
+  common::HtmlWriter writer;
+  writer.text("a<b & \"c\">");
+  writer << '|';
+  writer.attribute("a<b & \"c\">");
+  EXPECT_EQ("a&lt;b &amp; \"c\"&gt;|a&lt;b &amp; &quot;c&quot;&gt;",
+            writer.str());
+}
+
+TEST(HtmlWriter, blocks) {
+  std::ostringstream sink;
+  {
+    common::HtmlWriter writer(sink, 8);
+    writer << "1234";
+    EXPECT_EQ("", sink.str());
+    writer << std::string("5678");
+    EXPECT_EQ("12345678", sink.str());
+    writer << "9abc";
+    EXPECT_EQ("12345678", sink.str());
+  }
+  EXPECT_EQ("123456789abc", sink.str());
+}
+
+TEST(HtmlWriter, base64) {
+  // longer than a block of `HtmlWriter::base64`
+  std::string data(200000, '\0');
+  for (std::size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i * 7);
+  std::istringstream in(data);
+
+  common::HtmlWriter writer;
+  writer.base64("ab");
+  writer << '|';
+  writer.base64(in);
+  EXPECT_EQ("YWI=|" + crypto::Base64::encode(data), writer.str());
+}
+
+TEST(HtmlWriter, base64Failure) {
+  // like a zip entry failing to inflate halfway
+  struct FailingBuf final : public std::streambuf {
+    int underflow() final { throw std::runtime_error("inflate failed"); }
+  } buffer;
+  std::istream in(&buffer);
+
+  common::HtmlWriter writer;
+  EXPECT_THROW(writer.base64(in), std::ios_base::failure);
+}
+
+TEST(HtmlWriter, rollback) {
+  std::ostringstream sink;
+  {
+    common::HtmlWriter writer(sink, 8);
+    writer << "12";
+    const auto mark = writer.mark();
+    writer << "345";
+    EXPECT_TRUE(writer.rollback(mark));
+    writer << "abc";
+    const auto flushedMark = writer.mark();
+    writer << "defghijk";
+    EXPECT_EQ("12abcdefghijk", sink.str());
+    EXPECT_FALSE(writer.rollback(flushedMark));
+    writer << "l";
+  }
+  EXPECT_EQ("12abcdefghijkl", sink.str());
+}
@@ -0,0 +1,26 @@
+#include <common/HtmlWriter.h>
+#include <common/InlineStyles.h>
+#include <gtest/gtest.h>
+
+using namespace odr::common;
+
+TEST(InlineStyles, write) {
+  InlineStyles styles;
+  HtmlWriter out;
+  for (auto &&declarations :
+       {"font-size:11pt;", "font-weight:bold;", "font-size:11pt;"}) {
+    styles.write(declarations, out);
+    out << "|";
+  }
+  EXPECT_EQ("odr-i0|odr-i1|odr-i0|", out.str());
+
+  HtmlWriter css;
+  styles.css(css);
+  EXPECT_EQ(".odr-i0 {font-size:11pt;}\n.odr-i1 {font-weight:bold;}\n",
+            css.str());
+
+  styles.clear();
+  HtmlWriter empty;
+  styles.css(empty);
+  EXPECT_EQ("", empty.str());
+}
@@ -0,0 +1,40 @@
+#include <common/NameTable.h>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace odr::common;
+
+namespace {
+enum class Token {
+  NONE,
+  P,
+  SPAN,
+  TABLE,
+};
+
+constexpr auto tokens = nameTable<Token>({
+    {"text:p", Token::P},
+    {"text:span", Token::SPAN},
+    {"table:table", Token::TABLE},
+});
+} // namespace
+
+TEST(NameTable, find) {
+  static_assert(tokens.find("text:p", Token::NONE) == Token::P);
+  static_assert(tokens.find("text:h", Token::NONE) == Token::NONE);
+
+  EXPECT_EQ(Token::SPAN, tokens.find(std::string("text:span"), Token::NONE));
+  EXPECT_EQ(Token::TABLE, tokens.find("table:table", Token::NONE));
+  EXPECT_EQ(Token::NONE, tokens.find("table:table-row", Token::NONE));
+  EXPECT_EQ(Token::NONE, tokens.find("", Token::NONE));
+}
+
+TEST(NameTable, values) {
+  constexpr auto names = nameTable<const char *>({
+      {"fo:color", "color"},
+      {"fo:font-size", "font-size"},
+      {"style:font-name", "font-family"},
+  });
+  EXPECT_STREQ("font-family", names.find("style:font-name", nullptr));
+  EXPECT_EQ(nullptr, names.find("fo:margin", nullptr));
+}
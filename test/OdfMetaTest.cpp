@@ -0,0 +1,78 @@
+#include <access/ZipStorage.h>
+#include <gtest/gtest.h>
+#include <odf/src/Meta.h>
+#include <odr/Meta.h>
+#include <string>
+
+using namespace odr;
+
+namespace {
+FileMeta parse(const std::string &mimeType, const std::string &body) {
+  {
+    access::ZipWriter writer(std::string("odf_meta.zip"));
+    const auto mimeTypeSink = writer.write("mimetype");
+    mimeTypeSink->write(mimeType.data(), mimeType.size());
+    const std::string content =
+        "<office:document-content><office:body>" + body +
+        "</office:body></office:document-content>";
+    const auto contentSink = writer.write("content.xml");
+    contentSink->write(content.data(), content.size());
+  }
+  access::ZipReader reader(std::string("odf_meta.zip"));
+  return odf::Meta::parseFileMeta(reader, false);
+}
+
+const std::string spreadsheet =
+    "application/vnd.oasis.opendocument.spreadsheet";
+const std::string text = "application/vnd.oasis.opendocument.text";
+
+const std::string tables =
+    "<table:table table:name=\"one\">"
+    "<table:table-column table:number-columns-repeated=\"8\"/>"
+    "<table:table-row>"
+    "<table:table-cell><text:p>a</text:p></table:table-cell>"
+    "<table:table-cell table:number-columns-repeated=\"2\"/>"
+    "<table:table-cell><text:p>b</text:p></table:table-cell>"
+    "</table:table-row>"
+    "<table:table-row table:number-rows-repeated=\"3\">"
+    "<table:table-cell/>"
+    "</table:table-row>"
+    "<table:table-row><table:table-cell>"
+    "<table:table table:name=\"nested\">"
+    "<table:table-row table:number-rows-repeated=\"100\">"
+    "<table:table-cell table:number-columns-repeated=\"9\">"
+    "<text:p>c</text:p></table:table-cell>"
+    "</table:table-row>"
+    "</table:table>"
+    "</table:table-cell></table:table-row>"
+    "</table:table>"
+    "<table:table table:name=\"two\">"
+    "<table:table-rows><table:table-row>"
+    "<table:table-cell><text:p>d</text:p></table:table-cell>"
+    "</table:table-row></table:table-rows>"
+    "</table:table>";
+} // namespace
+
+TEST(OdfMeta, spreadsheetTables) {
+  const auto meta = parse(spreadsheet, "<office:spreadsheet>" + tables +
+                                           "</office:spreadsheet>");
+  EXPECT_EQ(FileType::OPENDOCUMENT_SPREADSHEET, meta.type);
+  EXPECT_EQ(3, meta.entryCount);
+  ASSERT_EQ(3, meta.entries.size());
+  EXPECT_EQ("one", meta.entries[0].name);
+  EXPECT_EQ(5, meta.entries[0].rowCount);
+  EXPECT_EQ(4, meta.entries[0].columnCount);
+  EXPECT_EQ("nested", meta.entries[1].name);
+  EXPECT_EQ(100, meta.entries[1].rowCount);
+  EXPECT_EQ(9, meta.entries[1].columnCount);
+  EXPECT_EQ("two", meta.entries[2].name);
+  EXPECT_EQ(1, meta.entries[2].rowCount);
+  EXPECT_EQ(1, meta.entries[2].columnCount);
+}
+
+TEST(OdfMeta, textTables) {
+  const auto meta = parse(text, "<office:text>" + tables + "</office:text>");
+  EXPECT_EQ(FileType::OPENDOCUMENT_TEXT, meta.type);
+  EXPECT_EQ(0, meta.entryCount);
+  EXPECT_TRUE(meta.entries.empty());
+}
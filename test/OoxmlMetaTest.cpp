@@ -0,0 +1,113 @@
+#include <access/Path.h>
+#include <access/ZipStorage.h>
+#include <gtest/gtest.h>
+#include <odr/Meta.h>
+#include <ooxml/src/Meta.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace odr;
+
+namespace {
+FileMeta parse(const std::vector<std::pair<std::string, std::string>> &parts) {
+  {
+    access::ZipWriter writer(std::string("ooxml_meta.zip"));
+    for (auto &&part : parts) {
+      const auto sink = writer.write(part.first);
+      sink->write(part.second.data(), part.second.size());
+    }
+  }
+  access::ZipReader reader(std::string("ooxml_meta.zip"));
+  return ooxml::Meta::parseFileMeta(reader);
+}
+
+const std::pair<std::string, std::string> document{
+    "word/document.xml", "<w:document><w:body/></w:document>"};
+const std::pair<std::string, std::string> presentation{
+    "ppt/presentation.xml",
+    "<p:presentation><p:sldIdLst><p:sldId r:id=\"rId1\"/>"
+    "<p:sldId r:id=\"rId2\"/></p:sldIdLst></p:presentation>"};
+
+FileMeta parseWorkbook(const std::string &sheet) {
+  return parse(
+      {{"xl/workbook.xml", "<workbook><sheets><sheet name=\"one\" "
+                           "r:id=\"rId1\"/></sheets></workbook>"},
+       {"xl/_rels/workbook.xml.rels",
+        "<Relationships><Relationship Id=\"rId1\" "
+        "Target=\"worksheets/sheet1.xml\"/></Relationships>"},
+       {"xl/worksheets/sheet1.xml", sheet}});
+}
+} // namespace
+
+TEST(OoxmlMeta, appPresent) {
+  const auto meta = parse(
+      {document, {"docProps/app.xml", "<Properties><Pages>3</Pages>"
+                                      "</Properties>"}});
+  EXPECT_EQ(FileType::OFFICE_OPEN_XML_DOCUMENT, meta.type);
+  EXPECT_EQ(3, meta.entryCount);
+  EXPECT_EQ(3, meta.entries.size());
+}
+
+TEST(OoxmlMeta, appAbsent) {
+  const auto meta = parse({document});
+  EXPECT_EQ(FileType::OFFICE_OPEN_XML_DOCUMENT, meta.type);
+  EXPECT_EQ(0, meta.entryCount);
+  EXPECT_TRUE(meta.entries.empty());
+}
+
+TEST(OoxmlMeta, appMalformed) {
+  const auto meta =
+      parse({document, {"docProps/app.xml", "<Properties><Pages>3"}});
+  EXPECT_EQ(FileType::OFFICE_OPEN_XML_DOCUMENT, meta.type);
+  EXPECT_EQ(0, meta.entryCount);
+  EXPECT_TRUE(meta.entries.empty());
+}
+
+TEST(OoxmlMeta, slides) {
+  // without slide parts the count of app.xml is not trusted
+  const auto meta =
+      parse({presentation, {"docProps/app.xml", "<Properties><Slides>5"
+                                                "</Slides></Properties>"}});
+  EXPECT_EQ(FileType::OFFICE_OPEN_XML_PRESENTATION, meta.type);
+  EXPECT_EQ(2, meta.entryCount);
+  EXPECT_EQ(2, meta.entries.size());
+
+  const auto malformed =
+      parse({presentation, {"docProps/app.xml", "<Properties"}});
+  EXPECT_EQ(2, malformed.entryCount);
+}
+
+TEST(OoxmlMeta, dimension) {
+  const auto meta = parseWorkbook(
+      "<worksheet><sheetPr/><dimension ref=\"A1:C5\"/><sheetData/>"
+      "</worksheet>");
+  EXPECT_EQ(FileType::OFFICE_OPEN_XML_WORKBOOK, meta.type);
+  EXPECT_EQ(1, meta.entryCount);
+  ASSERT_EQ(1, meta.entries.size());
+  EXPECT_EQ("one", meta.entries[0].name);
+  EXPECT_EQ(5, meta.entries[0].rowCount);
+  EXPECT_EQ(3, meta.entries[0].columnCount);
+
+  const auto single =
+      parseWorkbook("<worksheet><dimension ref=\"B2\"/></worksheet>");
+  EXPECT_EQ(2, single.entries[0].rowCount);
+  EXPECT_EQ(2, single.entries[0].columnCount);
+}
+
+TEST(OoxmlMeta, dimensionInvalid) {
+  // the entry is left as it is
+  const std::vector<std::string> sheets{
+      "<worksheet><sheetData/><dimension ref=\"A1:C5\"/></worksheet>",
+      "<worksheet><dimension/></worksheet>",
+      "<worksheet><dimension ref=\"A1:?\"/></worksheet>",
+      "<worksheet><dimension ref=\"A1:C99999999999999999999\"/></worksheet>",
+      "<worksheet><dimension ref=\"A1:C5\"",
+  };
+  for (auto &&sheet : sheets) {
+    const auto meta = parseWorkbook(sheet);
+    ASSERT_EQ(1, meta.entries.size());
+    EXPECT_EQ(0, meta.entries[0].rowCount);
+    EXPECT_EQ(0, meta.entries[0].columnCount);
+  }
+}
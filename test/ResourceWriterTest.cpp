@@ -0,0 +1,113 @@
+#include <access/Path.h>
+#include <access/Storage.h>
+#include <common/ResourceWriter.h>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+using namespace odr;
+namespace fs = std::filesystem;
+
+namespace {
+std::string readFile(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in), {});
+}
+
+class MemoryStorage final : public access::ReadStorage {
+public:
+  std::unordered_map<access::Path, std::string> files;
+
+  bool isSomething(const access::Path &path) const final {
+    return isFile(path);
+  }
+  bool isFile(const access::Path &path) const final {
+    return files.find(path) != files.end();
+  }
+  bool isDirectory(const access::Path &) const final { return false; }
+  bool isReadable(const access::Path &path) const final {
+    return isFile(path);
+  }
+  std::uint64_t size(const access::Path &path) const final {
+    return files.at(path).size();
+  }
+  void visit(Visitor visitor) const final {
+    for (auto &&f : files)
+      visitor(f.first);
+  }
+  std::unique_ptr<std::istream> read(const access::Path &path) const final {
+    if (!isFile(path))
+      return nullptr;
+    return std::make_unique<std::istringstream>(files.at(path));
+  }
+};
+
+std::size_t countFiles(const fs::path &directory) {
+  std::size_t result = 0;
+  for (auto &&entry : fs::directory_iterator(directory))
+    result += entry.is_regular_file() ? 1 : 0;
+  return result;
+}
+} // namespace
+
+TEST(ResourceWriter, write) {
+  const fs::path directory =
+      fs::temp_directory_path() / "odr_resource_writer_test";
+  fs::remove_all(directory);
+  fs::create_directories(directory / "html");
+
+  common::ResourceWriter resources((directory / "res").string(),
+                                   (directory / "html").string());
+  const std::string &url = resources.write("Pictures/a.svg", "<svg/>");
+  EXPECT_EQ(0, url.rfind("../res/", 0));
+  EXPECT_EQ(".svg", url.substr(url.size() - 4));
+  EXPECT_EQ("<svg/>", readFile((directory / "html" / url).string()));
+  // written once per path
+  EXPECT_EQ(url, resources.write("Pictures/a.svg", "<other/>"));
+  // equal content is stored once
+  EXPECT_EQ(url, resources.write("../../b.svg", "<svg/>"));
+  EXPECT_EQ(1, countFiles(directory / "res"));
+
+  fs::remove_all(directory);
+}
+
+TEST(ResourceWriter, shared) {
+  const fs::path directory =
+      fs::temp_directory_path() / "odr_resource_writer_shared_test";
+  fs::remove_all(directory);
+
+  // two documents with different images of equal name and size
+  MemoryStorage first;
+  first.files["word/media/image1.png"] = "first image";
+  MemoryStorage second;
+  second.files["word/media/image1.png"] = "other image";
+
+  std::string firstUrl;
+  {
+    common::ResourceWriter resources(directory.string(), directory.string());
+    firstUrl = resources.write(first, "word/media/image1.png");
+  }
+  std::string secondUrl;
+  {
+    common::ResourceWriter resources(directory.string(), directory.string());
+    secondUrl = resources.write(second, "word/media/image1.png");
+    // reused by a later translation
+    common::ResourceWriter again(directory.string(), directory.string());
+    EXPECT_EQ(secondUrl, again.write(second, "word/media/image1.png"));
+  }
+
+  EXPECT_NE(firstUrl, secondUrl);
+  EXPECT_EQ("first image", readFile((directory / firstUrl).string()));
+  EXPECT_EQ("other image", readFile((directory / secondUrl).string()));
+  EXPECT_EQ(2, countFiles(directory));
+
+  common::ResourceWriter resources(directory.string(), directory.string());
+  EXPECT_THROW(resources.write(first, "word/media/missing.png"),
+               access::FileNotFoundException);
+
+  fs::remove_all(directory);
+}
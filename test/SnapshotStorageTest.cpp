@@ -0,0 +1,96 @@
+#include <access/Path.h>
+#include <access/SnapshotStorage.h>
+#include <access/StorageUtil.h>
+#include <access/ZipStorage.h>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace odr::access;
+
+namespace {
+// number of mappings of files named `file`, zero where this is unknown
+int mappings(const std::string &file) {
+  int result = 0;
+  std::ifstream maps("/proc/self/maps");
+  for (std::string line; std::getline(maps, line);) {
+    if (line.find("/" + file) != std::string::npos)
+      ++result;
+  }
+  return result;
+}
+
+void createSnapshot(const std::string &file) {
+  {
+    ZipWriter writer(std::string("snapshot.zip"));
+    writer.createDirectory("dir");
+    const auto sink = writer.write("dir/one.txt");
+    sink->write("this is written at once", 23);
+  }
+  SnapshotReader::write(file, ZipReader(std::string("snapshot.zip")), "head");
+}
+} // namespace
+
+TEST(SnapshotReader, exception) {
+  EXPECT_THROW(SnapshotReader("missing.odrsnap"), FileNotFoundException);
+  // not a regular file
+  EXPECT_THROW(SnapshotReader("/"), NoSnapshotFileException);
+}
+
+TEST(SnapshotReader, roundtrip) {
+  createSnapshot("snapshot.odrsnap");
+
+  const SnapshotReader reader("snapshot.odrsnap");
+  EXPECT_EQ("head", reader.header());
+  EXPECT_TRUE(reader.isDirectory("dir"));
+  EXPECT_TRUE(reader.isFile("dir/one.txt"));
+  EXPECT_EQ(23, reader.size("dir/one.txt"));
+  EXPECT_EQ("this is written at once",
+            StorageUtil::read(reader, "dir/one.txt"));
+}
+
+TEST(SnapshotReader, corrupted) {
+  createSnapshot("snapshot.odrsnap");
+
+  {
+    std::fstream file("snapshot.odrsnap",
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(32);
+    file.put('X');
+  }
+
+  const SnapshotReader reader("snapshot.odrsnap");
+  EXPECT_THROW(reader.read("dir/one.txt"), SnapshotCorruptedException);
+}
+
+TEST(SnapshotReader, noSnapshot) {
+  {
+    std::ofstream file("snapshot.odrsnap", std::ios::binary);
+    file << "this is not a snapshot file at all";
+  }
+  EXPECT_THROW(SnapshotReader("snapshot.odrsnap"), NoSnapshotFileException);
+}
+
+TEST(SnapshotReader, noMappingLeft) {
+  {
+    std::ofstream file("snapshot.odrsnap", std::ios::binary);
+    file << std::string(4096, 'x');
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_THROW(SnapshotReader("snapshot.odrsnap"), NoSnapshotFileException);
+  }
+  EXPECT_EQ(0, mappings("snapshot.odrsnap"));
+
+  createSnapshot("snapshot.odrsnap");
+  {
+    // the version is only checked once the file is mapped
+    std::fstream file("snapshot.odrsnap",
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(8);
+    file.put('X');
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_THROW(SnapshotReader("snapshot.odrsnap"), SnapshotVersionException);
+  }
+  EXPECT_EQ(0, mappings("snapshot.odrsnap"));
+}
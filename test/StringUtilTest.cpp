@@ -0,0 +1,55 @@
+#include <common/StringUtil.h>
+#include <common/src/XmlSpecialFinders.h>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace odr::common;
+
+TEST(StringUtil, escapeXml) {
+  std::string out;
+  StringUtil::escapeXml(out, "a<b & \"c\">", false);
+  EXPECT_EQ("a&lt;b &amp; \"c\"&gt;", out);
+  out.clear();
+  StringUtil::escapeXml(out, "a<b & \"c\">", true);
+  EXPECT_EQ("a&lt;b &amp; &quot;c&quot;&gt;", out);
+}
+
+TEST(StringUtil, findXmlSpecial) {
+  // long enough for the vectorized loops and their scalar tails
+  for (std::size_t size = 0; size < 100; ++size) {
+    for (std::size_t at = 0; at < size; ++at) {
+      for (const char c : {'&', '<', '>', '"'}) {
+        std::string string(size, 'x');
+        string[at] = c;
+        EXPECT_EQ(at, StringUtil::findXmlSpecial(string, 0, true));
+        EXPECT_EQ(c == '"' ? std::string::npos : at,
+                  StringUtil::findXmlSpecial(string, 0, false));
+        EXPECT_EQ(std::string::npos,
+                  StringUtil::findXmlSpecial(string, at + 1, true));
+      }
+    }
+  }
+}
+
+TEST(StringUtil, xmlSpecialFinders) {
+  const auto &finders = StringUtil::xmlSpecialFinders();
+  ASSERT_NE(nullptr, finders.scalar);
+  for (auto &&find : {finders.scalar, finders.sse2, finders.avx2}) {
+    if (find == nullptr)
+      continue;
+    for (std::size_t size = 0; size < 100; ++size) {
+      for (std::size_t at = 0; at < size; ++at) {
+        for (const char c : {'&', '<', '>', '"'}) {
+          std::string string(size, 'x');
+          string[at] = c;
+          EXPECT_EQ(at, find(string.data(), 0, size, true));
+          EXPECT_EQ(c == '"' ? std::string::npos : at,
+                    find(string.data(), 0, size, false));
+          EXPECT_EQ(std::string::npos, find(string.data(), at + 1, size, true));
+          // the end is respected even if more data follows
+          EXPECT_EQ(std::string::npos, find(string.data(), 0, at, true));
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,113 @@
+#include <common/HtmlWriter.h>
+#include <common/StyleClasses.h>
+#include <common/StyleSheet.h>
+#include <gtest/gtest.h>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace odr::common;
+
+TEST(StyleClasses, write) {
+  const std::unordered_map<std::string, std::list<std::string>> dependencies{
+      {"a", {"b", "c\""}}, {"d", {}}};
+  StyleClasses classes;
+  classes.resolve(dependencies);
+
+  HtmlWriter out;
+  classes.write("a", out);
+  out << "|";
+  classes.write("d", out);
+  out << "|";
+  classes.write("e&", out);
+  EXPECT_EQ("a c&quot; b|d|e&amp;", out.str());
+
+  classes.resolve({});
+  HtmlWriter cleared;
+  classes.write("a", cleared);
+  EXPECT_EQ("a", cleared.str());
+}
+
+TEST(StyleClasses, used) {
+  const std::unordered_map<std::string, std::list<std::string>> dependencies{
+      {"a", {"b"}}, {"b", {"c"}}, {"d", {"e"}}};
+  StyleClasses classes;
+  classes.resolve(dependencies);
+
+  HtmlWriter out;
+  classes.write("a", out);
+  classes.write("f", out);
+  EXPECT_EQ((std::unordered_set<std::string>{"a", "b", "c", "f"}),
+            classes.used(dependencies));
+}
+
+TEST(StyleClasses, flatten) {
+  const StyleSheet styleSheet{".P.P {color:red;}\n.Q.Q {color:red;}\n"
+                              ".para.para {font-size:10pt;}\n"
+                              "ul.L li {list-style: none;}\n",
+                              {}};
+  const std::unordered_map<std::string, std::list<std::string>> dependencies{
+      {"P", {"para"}}, {"Q", {"para"}}, {"L", {}}};
+  StyleClasses classes;
+  classes.flatten({&styleSheet}, dependencies);
+
+  HtmlWriter out;
+  for (auto &&name : {"P", "Q", "para", "L", "X"}) {
+    classes.write(name, out);
+    out << "|";
+  }
+  EXPECT_EQ("odr-s0|odr-s0|odr-s1|L|X|", out.str());
+
+  HtmlWriter css;
+  classes.css(css, nullptr);
+  EXPECT_EQ("\nul.L li {list-style: none;}"
+            ".odr-s0.odr-s0 {color:red;font-size:10pt;}\n"
+            ".odr-s1.odr-s1 {font-size:10pt;}\n",
+            css.str());
+}
+
+TEST(StyleClasses, flattenUsed) {
+  const StyleSheet styleSheet{".a {x:1;x:2;y:3}\n.b {x:1;}\n.c .d {z:1;}", {}};
+  const std::unordered_map<std::string, std::list<std::string>> dependencies{
+      {"a", {"b"}}};
+  StyleClasses classes;
+  classes.flatten({&styleSheet}, dependencies);
+
+  HtmlWriter out;
+  classes.write("a", out);
+  EXPECT_EQ("odr-s0", out.str());
+
+  const auto used = classes.used(dependencies);
+  HtmlWriter css;
+  classes.css(css, &used);
+  EXPECT_EQ(".odr-s0 {y:3;x:1;}\n", css.str());
+}
+
+TEST(StyleClasses, flattenSpecificity) {
+  // `.a.a` wins over the later `.a` in the cascade and in the merge
+  const StyleSheet styleSheet{".a.a {x:1;}\n.a {x:2;y:2;}", {}};
+  StyleClasses classes;
+  classes.flatten({&styleSheet}, {{"a", {}}});
+
+  HtmlWriter css;
+  classes.css(css, nullptr);
+  EXPECT_EQ(".odr-s0.odr-s0 {y:2;x:1;}\n", css.str());
+}
+
+TEST(StyleClasses, flattenTies) {
+  // `[title]` ties with `.a` and comes later; source order decides
+  const StyleSheet styleSheet{".a {x:1;}\n[title] {x:2;}", {}};
+  const std::unordered_map<std::string, std::list<std::string>> dependencies{
+      {"a", {"b"}}};
+  StyleClasses classes;
+  classes.flatten({&styleSheet}, dependencies);
+
+  HtmlWriter out;
+  classes.write("a", out);
+  EXPECT_EQ("a b", out.str());
+
+  HtmlWriter css;
+  classes.css(css, nullptr);
+  EXPECT_EQ(styleSheet.css, css.str());
+}
@@ -0,0 +1,80 @@
+#include <common/HtmlWriter.h>
+#include <common/StyleSheet.h>
+#include <gtest/gtest.h>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace odr::common;
+
+namespace {
+struct Context {
+  HtmlWriter *output;
+  std::unordered_map<std::string, std::list<std::string>> styleDependencies;
+};
+} // namespace
+
+TEST(StyleSheet, compile) {
+  HtmlWriter out;
+  Context context{&out, {{"a", {"b"}}}};
+
+  const StyleSheet styleSheet = StyleSheet::compile(context, [&]() {
+    *context.output << ".c {}";
+    context.styleDependencies["c"].push_back("d");
+  });
+
+  EXPECT_EQ(".c {}", styleSheet.css);
+  EXPECT_EQ(1, styleSheet.dependencies.size());
+  EXPECT_EQ(&out, context.output);
+  EXPECT_EQ("", out.str());
+  EXPECT_EQ(1, context.styleDependencies.size());
+
+  styleSheet.link(context);
+  EXPECT_EQ(std::list<std::string>{"d"}, context.styleDependencies["c"]);
+}
+
+TEST(StyleSheet, classes) {
+  using Classes = std::vector<std::string_view>;
+  EXPECT_EQ((Classes{"a", "b", "c"}), StyleSheet::classes("p.a.b > .c:hover"));
+  EXPECT_EQ(Classes{}, StyleSheet::classes("@media (min-width:1.5em)"));
+  EXPECT_EQ(Classes{}, StyleSheet::classes(" @supports (x:.5)"));
+  EXPECT_EQ(Classes{"b"}, StyleSheet::classes("p:not(.a).b"));
+  EXPECT_EQ(Classes{"c"}, StyleSheet::classes("a[href$=\".pdf\"] .c"));
+}
+
+TEST(StyleSheet, prune) {
+  const StyleSheet styleSheet{
+      ".a.a {x:1;}\n.b.b {x:2;}\nul.c li:before {content: \"}\";}\n"
+      "@font-face {font-family:d;}\n.e, .b {x:3;}\n"
+      "@media (min-width:1.5em) {.a {x:4;}}",
+      {}};
+
+  EXPECT_EQ(".a.a {x:1;}\n@font-face {font-family:d;}\n"
+            "@media (min-width:1.5em) {.a {x:4;}}",
+            styleSheet.prune({"a"}));
+  EXPECT_EQ("\nul.c li:before {content: \"}\";}\n"
+            "@font-face {font-family:d;}\n.e, .b {x:3;}\n"
+            "@media (min-width:1.5em) {.a {x:4;}}",
+            styleSheet.prune({"c", "e"}));
+}
+
+TEST(StyleSheetCache, get) {
+  StyleSheetCache cache(1);
+  int compiled = 0;
+  const auto compile = [&]() {
+    ++compiled;
+    return StyleSheet{".a {}", {}};
+  };
+
+  const auto a = cache.get("a", compile);
+  EXPECT_EQ(a, cache.get("a", compile));
+  EXPECT_EQ(1, compiled);
+
+  cache.get("b", compile);
+  EXPECT_EQ(1, cache.size());
+  EXPECT_NE(a, cache.get("a", compile));
+  EXPECT_EQ(3, compiled);
+}
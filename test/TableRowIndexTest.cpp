@@ -0,0 +1,38 @@
+#include <common/TableRowIndex.h>
+#include <gtest/gtest.h>
+
+TEST(TableRowIndex, empty) {
+  odr::common::TableRowIndex index;
+  EXPECT_TRUE(index.empty());
+}
+
+TEST(TableRowIndex, stride) {
+  odr::common::TableRowIndex index(10);
+  for (std::uint32_t row = 5; row < 100; row += 3) {
+    index.add(row, 1000 + row);
+  }
+  // a repeated run covering many rows is a single element
+  index.add(102, 2000);
+  index.add(1000000, 3000);
+
+  EXPECT_EQ(index.begin(), 1005);
+  ASSERT_EQ(index.marks().size(), 10);
+  EXPECT_EQ(index.marks()[1].row, 17);
+  EXPECT_EQ(index.marks()[1].offset, 1017);
+
+  EXPECT_EQ(index.find(0).row, 5);
+  EXPECT_EQ(index.find(16).row, 5);
+  EXPECT_EQ(index.find(17).row, 17);
+  EXPECT_EQ(index.find(500000).offset, 2000);
+  EXPECT_EQ(index.find(1000050).offset, 3000);
+}
+
+TEST(TableRowIndex, backwards) {
+  odr::common::TableRowIndex index(1);
+  index.add(5, 0);
+  index.add(3, 10);
+  index.add(6, 20);
+  ASSERT_EQ(index.marks().size(), 2);
+  EXPECT_EQ(index.find(5).offset, 0);
+  EXPECT_EQ(index.find(6).offset, 20);
+}
@@ -0,0 +1,114 @@
+#include <access/StreamUtil.h>
+#include <chrono>
+#include <common/TokenDom.h>
+#include <common/XmlArena.h>
+#include <common/XmlUtil.h>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <pugixml.hpp>
+#include <string>
+#include <string_view>
+
+using namespace odr;
+
+namespace {
+// shaped like the `content.xml` of a spreadsheet
+std::string spreadsheet(const std::uint32_t rows) {
+  std::string result = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                       "<office:document-content><office:body>"
+                       "<office:spreadsheet><table:table table:name=\"a\">";
+  for (std::uint32_t row = 0; row < rows; ++row) {
+    result += "<table:table-row table:style-name=\"ro1\">";
+    for (std::uint32_t column = 0; column < 16; ++column) {
+      result += "<table:table-cell table:style-name=\"ce" +
+                std::to_string(column) +
+                "\" office:value-type=\"float\" office:value=\"" +
+                std::to_string(row * column) + "\"><text:p>" +
+                std::to_string(row * column) + "</text:p></table:table-cell>";
+    }
+    result += "</table:table-row>";
+  }
+  result += "</table:table></office:spreadsheet></office:body>"
+            "</office:document-content>";
+  return result;
+}
+
+// touches what `ContentTranslator` reads: names, a few attributes and text
+std::uint64_t walk(const pugi::xml_node &in) {
+  std::uint64_t result = 0;
+  for (auto &&n : in) {
+    const std::string_view styleName = n.attribute("table:style-name").value();
+    result += std::string_view(n.name()).size();
+    result += styleName.size();
+    result += n.attribute("table:number-columns-repeated").as_uint(1);
+    if (n.type() == pugi::node_pcdata)
+      result += std::string_view(n.value()).size();
+    result += walk(n);
+  }
+  return result;
+}
+
+std::uint64_t walk(const common::TokenDom::Node &in) {
+  std::uint64_t result = 0;
+  for (auto &&n : in) {
+    result += n.name().size();
+    result += n.attribute("table:style-name").as_string().size();
+    result += n.attribute("table:number-columns-repeated").as_uint(1);
+    result += n.isText() ? n.text().size() : 0;
+    result += walk(n);
+  }
+  return result;
+}
+
+template <typename Run> double measure(Run run) {
+  const auto begin = std::chrono::steady_clock::now();
+  run();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+} // namespace
+
+// compares parsing and walking a `content.xml` with pugixml and with
+// `common::TokenDom`. takes the path of an xml file or generates a
+// spreadsheet with the given number of rows.
+int main(int argc, char **argv) {
+  std::string xml;
+  if ((argc > 1) && (std::string(argv[1]).find_first_not_of("0123456789") !=
+                     std::string::npos)) {
+    std::ifstream in(argv[1]);
+    xml = access::StreamUtil::read(in);
+  } else {
+    xml = spreadsheet(argc > 1 ? std::stoul(argv[1]) : 20000);
+  }
+
+  std::uint64_t pugiMemory = 0;
+  std::uint64_t pugiWalk = 0;
+  const double pugiTime = measure([&]() {
+    common::XmlArena arena;
+    {
+      common::XmlArena::Scope scope(arena);
+      const auto document = common::XmlUtil::parse(xml);
+      pugiWalk = walk(document);
+    }
+    pugiMemory = arena.stats().peak;
+  });
+
+  std::uint64_t tokenMemory = 0;
+  std::uint64_t tokenWalk = 0;
+  const double tokenTime = measure([&]() {
+    const common::TokenDom dom(xml);
+    tokenWalk = walk(dom.document());
+    tokenMemory = dom.memory();
+  });
+
+  if (pugiWalk != tokenWalk)
+    std::cerr << "walks differ: " << pugiWalk << " " << tokenWalk << std::endl;
+
+  std::cout << xml.size() / 1024 << " KiB xml" << std::endl;
+  std::cout << "pugixml:          " << pugiTime << " ms, "
+            << pugiMemory / 1024 << " KiB" << std::endl;
+  std::cout << "common::TokenDom: " << tokenTime << " ms, "
+            << tokenMemory / 1024 << " KiB" << std::endl;
+  std::cout << "speedup:          " << pugiTime / tokenTime << std::endl;
+}
@@ -0,0 +1,106 @@
+#include <common/TokenDom.h>
+#include <common/XmlUtil.h>
+#include <gtest/gtest.h>
+#include <pugixml.hpp>
+#include <string>
+
+using namespace odr;
+
+namespace {
+const std::string xml =
+    "<?xml version=\"1.0\"?>\r\n<!-- comment -->"
+    "<a:root x=\"1&amp;2\r\n3\" y='&#x41;&#66;&unknown;'>\n  <b/>"
+    "te&lt;xt\r\nz<![CDATA[<raw>]]><c  k = \"v\" ></c ><d>  </d></a:root>";
+
+void compare(const pugi::xml_node &expected,
+             const common::TokenDom::Node &actual) {
+  auto e = expected.first_child();
+  auto a = actual.first_child();
+  for (; e && a; e = e.next_sibling(), a = a.next_sibling()) {
+    switch (e.type()) {
+    case pugi::node_element: {
+      ASSERT_TRUE(a.isElement());
+      EXPECT_EQ(e.name(), a.name());
+      auto ea = e.first_attribute();
+      for (auto &&aa : a.attributes()) {
+        ASSERT_TRUE(ea);
+        EXPECT_EQ(ea.name(), aa.name());
+        EXPECT_EQ(ea.value(), aa.as_string());
+        ea = ea.next_attribute();
+      }
+      EXPECT_FALSE(ea);
+      compare(e, a);
+    } break;
+    case pugi::node_pcdata:
+      ASSERT_TRUE(a.isText());
+      EXPECT_EQ(e.value(), a.text());
+      break;
+    case pugi::node_cdata:
+      ASSERT_TRUE(a.isCdata());
+      EXPECT_EQ(e.value(), a.text());
+      break;
+    default:
+      FAIL() << "unexpected node type " << e.type();
+    }
+  }
+  EXPECT_FALSE(e);
+  EXPECT_FALSE(a);
+}
+} // namespace
+
+TEST(TokenDom, pugixml) {
+  const auto expected = common::XmlUtil::parse(xml);
+  const common::TokenDom actual(xml);
+  compare(expected, actual.document());
+}
+
+TEST(TokenDom, tree) {
+  const common::TokenDom dom(xml);
+  const auto root = dom.document().child("a:root");
+  ASSERT_TRUE(root);
+  EXPECT_EQ("1&2 3", root.attribute("x").as_string());
+  EXPECT_EQ("AB&unknown;", root.attribute("y").as_string());
+  EXPECT_FALSE(root.attribute("z"));
+  EXPECT_EQ(7, root.attribute("z").as_uint(7));
+  EXPECT_EQ("v", root.child("c").attribute("k").as_string());
+  // whitespace-only text is dropped
+  EXPECT_FALSE(root.child("d").first_child());
+  EXPECT_FALSE(root.child("e"));
+
+  std::string names;
+  for (auto &&n : root) {
+    if (n.isElement())
+      names += n.name();
+    else
+      names += "[" + std::string(n.text()) + "]";
+  }
+  EXPECT_EQ("b[te<xt\nz][<raw>]cd", names);
+}
+
+TEST(TokenDom, tokens) {
+  const common::TokenDom dom(xml);
+  const auto token = dom.token("c");
+  EXPECT_NE(common::TokenDom::noToken, token);
+  EXPECT_EQ("c", dom.name(token));
+  EXPECT_EQ(common::TokenDom::noToken, dom.token("e"));
+  const auto root = dom.document().child("a:root");
+  EXPECT_EQ(token, root.child("c").token());
+  EXPECT_EQ(root.attribute("x").token(), dom.token("x"));
+  EXPECT_EQ("1&2 3", root.attribute(dom.token("x")).as_string());
+  EXPECT_LT(xml.size(), dom.memory());
+}
+
+TEST(TokenDom, malformed) {
+  for (auto &&in : {"", "<a>", "<a></b>", "<a x=1/>", "</a>", "<a><!-- </a>"}) {
+    EXPECT_THROW(common::TokenDom dom(in), common::NotXmlException) << in;
+  }
+}
+
+TEST(TokenDom, characterReferences) {
+  const common::TokenDom dom(
+      "<a x=\"&#x10FFFF;&#x110000;&#1114112;\">&#xFFFFFFFF;</a>");
+  const auto root = dom.document().child("a");
+  EXPECT_EQ("\xf4\x8f\xbf\xbf\xef\xbf\xbd\xef\xbf\xbd",
+            root.attribute("x").as_string());
+  EXPECT_EQ("\xef\xbf\xbd", root.first_child().text());
+}
@@ -0,0 +1,69 @@
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <odr/Config.h>
+#include <odr/TranslationCache.h>
+#include <string>
+
+using namespace odr;
+
+namespace {
+void writeFile(const std::string &path, const std::string &content) {
+  std::ofstream out(path, std::ios::binary);
+  out << content;
+}
+
+std::string readFile(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in), {});
+}
+} // namespace
+
+TEST(TranslationCache, configKey) {
+  Config a;
+  Config b;
+  EXPECT_EQ(TranslationCache::configKey(a), TranslationCache::configKey(b));
+  b.entryOffset = 1;
+  EXPECT_NE(TranslationCache::configKey(a), TranslationCache::configKey(b));
+}
+
+TEST(TranslationCache, inputKey) {
+  writeFile("cache_input_a.txt", "a");
+  writeFile("cache_input_b.txt", "b");
+  EXPECT_EQ(32, TranslationCache::inputKey("cache_input_a.txt").size());
+  EXPECT_NE(TranslationCache::inputKey("cache_input_a.txt"),
+            TranslationCache::inputKey("cache_input_b.txt"));
+}
+
+TEST(TranslationCache, publish_lookup) {
+  std::filesystem::remove_all("cache");
+  const TranslationCache cache("cache", 1024);
+  writeFile("cache_output.html", "<html></html>");
+
+  EXPECT_FALSE(cache.lookup("input", "config", "cache_hit.html"));
+  cache.publish("input", "config", "cache_output.html");
+  EXPECT_TRUE(cache.lookup("input", "config", "cache_hit.html"));
+  EXPECT_EQ("<html></html>", readFile("cache_hit.html"));
+  EXPECT_EQ(13, cache.size());
+
+  cache.invalidate("input");
+  EXPECT_FALSE(cache.lookup("input", "config", "cache_hit.html"));
+  EXPECT_EQ(0, cache.size());
+}
+
+TEST(TranslationCache, evict) {
+  std::filesystem::remove_all("cache");
+  const TranslationCache cache("cache", 20);
+  writeFile("cache_output.html", "0123456789");
+
+  cache.publish("input", "a", "cache_output.html");
+  cache.publish("input", "b", "cache_output.html");
+  EXPECT_EQ(20, cache.size());
+  cache.publish("input", "c", "cache_output.html");
+  EXPECT_EQ(20, cache.size());
+  // the entry just published stays even if all times are equal
+  EXPECT_TRUE(cache.lookup("input", "c", "cache_lookup.html"));
+
+  cache.clear();
+  EXPECT_EQ(0, cache.size());
+}
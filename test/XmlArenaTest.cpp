@@ -0,0 +1,53 @@
+#include <common/XmlArena.h>
+#include <common/XmlUtil.h>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <pugixml.hpp>
+
+using namespace odr;
+
+TEST(XmlArena, reuse) {
+  common::XmlArena arena(1024);
+
+  void *first = arena.allocate(100);
+  void *second = arena.allocate(2000);
+  EXPECT_EQ(2, arena.live());
+  EXPECT_THROW(arena.reset(), common::XmlArenaInUseException);
+  arena.deallocate(first);
+  arena.deallocate(second);
+  const auto reserved = arena.stats().reserved;
+  EXPECT_LE(2100, arena.stats().peak);
+
+  arena.reset();
+  EXPECT_EQ(0, arena.stats().used);
+  EXPECT_EQ(first, arena.allocate(100));
+  EXPECT_EQ(reserved, arena.stats().reserved);
+  EXPECT_LT(0, arena.stats().reused);
+  arena.deallocate(first);
+}
+
+TEST(XmlArena, scope) {
+  common::XmlArena arena;
+  {
+    common::XmlArena::Scope scope(arena);
+    EXPECT_EQ(&arena, common::XmlArena::current());
+    const auto document = common::XmlUtil::parse("<a><b>text</b></a>");
+    EXPECT_STREQ("text", document.child("a").child("b").text().get());
+    EXPECT_LT(0, arena.live());
+  }
+  EXPECT_EQ(nullptr, common::XmlArena::current());
+  EXPECT_EQ(0, arena.live());
+  EXPECT_LT(0, arena.stats().peak);
+  arena.reset();
+}
+
+TEST(XmlArena, foreignBlocks) {
+  // allocated by the default pugixml functions before the hooks were
+  // installed
+  void *foreign = std::malloc(64);
+  common::XmlArena::installHooks();
+  pugi::get_memory_deallocation_function()(foreign);
+
+  const auto document = common::XmlUtil::parse("<a/>");
+  EXPECT_TRUE(document.child("a"));
+}
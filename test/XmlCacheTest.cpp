@@ -0,0 +1,63 @@
+#include <access/Path.h>
+#include <access/ZipStorage.h>
+#include <common/XmlCache.h>
+#include <gtest/gtest.h>
+#include <pugixml.hpp>
+#include <string>
+
+using namespace odr;
+
+namespace {
+void createZip(const std::string &file) {
+  access::ZipWriter writer(file);
+  const std::string content = "<a><b/></a>";
+  for (auto &&name : {"one.xml", "two.xml"}) {
+    const auto sink = writer.write(name);
+    sink->write(content.data(), content.size());
+  }
+}
+} // namespace
+
+TEST(XmlCache, reuse) {
+  createZip("xmlcache.zip");
+  const access::ZipReader storage("xmlcache.zip");
+  common::XmlCache cache(&storage);
+  cache.setLimit(1024);
+
+  const auto one = cache.get("one.xml");
+  EXPECT_TRUE(one->child("a").child("b"));
+  EXPECT_EQ(one, cache.get("one.xml"));
+  EXPECT_LT(0, cache.size());
+
+  cache.clear();
+  EXPECT_EQ(0, cache.size());
+  EXPECT_NE(one, cache.get("one.xml"));
+}
+
+TEST(XmlCache, limit) {
+  createZip("xmlcache.zip");
+  const access::ZipReader storage("xmlcache.zip");
+  common::XmlCache cache(&storage);
+
+  EXPECT_NE(cache.get("one.xml"), cache.get("one.xml"));
+  EXPECT_EQ(0, cache.size());
+
+  // room for one part only
+  cache.setLimit(40);
+  const auto one = cache.get("one.xml");
+  cache.get("two.xml");
+  EXPECT_NE(one, cache.get("one.xml"));
+}
+
+TEST(XmlCache, setStorage) {
+  createZip("xmlcache.zip");
+  const access::ZipReader storage("xmlcache.zip");
+  common::XmlCache cache(&storage);
+  cache.setLimit(1024);
+
+  const auto one = cache.get("one.xml");
+  // a replaced storage can reuse the address of the old one
+  cache.setStorage(&storage);
+  EXPECT_EQ(0, cache.size());
+  EXPECT_NE(one, cache.get("one.xml"));
+}
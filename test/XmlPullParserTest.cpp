@@ -0,0 +1,65 @@
+#include <common/XmlPullParser.h>
+#include <common/XmlUtil.h>
+#include <gtest/gtest.h>
+#include <pugixml.hpp>
+#include <sstream>
+#include <string>
+
+using namespace odr;
+
+namespace {
+using Event = common::XmlPullParser::Event;
+
+const std::string xml =
+    "<?xml version=\"1.0\"?>\r\n<!-- comment -->"
+    "<a x=\"1&amp;2\r\n3\" y='>'>\n  <b/>te&lt;xt&#x41;&#66;\r\nz"
+    "<![CDATA[<raw>]]><c  k = \"v\" ></c ></a>";
+} // namespace
+
+TEST(XmlPullParser, events) {
+  // tiny chunks force tokens to span refills
+  std::istringstream in(xml);
+  common::XmlPullParser parser(in, 3);
+
+  EXPECT_EQ(Event::START_ELEMENT, parser.next());
+  EXPECT_EQ("a", parser.name());
+  EXPECT_EQ(1, parser.depth());
+  EXPECT_STREQ("1&2 3", parser.attribute("x"));
+  EXPECT_STREQ(">", parser.attribute("y"));
+  EXPECT_EQ(Event::START_ELEMENT, parser.next());
+  EXPECT_EQ("b", parser.name());
+  EXPECT_EQ(2, parser.depth());
+  EXPECT_EQ(Event::END_ELEMENT, parser.next());
+  EXPECT_EQ(Event::TEXT, parser.next());
+  EXPECT_EQ("te<xtAB\nz", parser.text());
+  EXPECT_EQ(Event::CDATA, parser.next());
+  EXPECT_EQ("<raw>", parser.text());
+  EXPECT_EQ(Event::START_ELEMENT, parser.next());
+  EXPECT_STREQ("v", parser.attribute("k"));
+  parser.skip();
+  EXPECT_EQ(Event::END_ELEMENT, parser.next());
+  EXPECT_EQ("a", parser.name());
+  EXPECT_EQ(Event::END_DOCUMENT, parser.next());
+}
+
+TEST(XmlPullParser, copy) {
+  std::istringstream in(xml);
+  common::XmlPullParser parser(in);
+  pugi::xml_document copy;
+  EXPECT_EQ(Event::START_ELEMENT, parser.next());
+  parser.copy(copy);
+
+  std::ostringstream expected;
+  common::XmlUtil::parse(xml).print(expected);
+  std::ostringstream actual;
+  copy.print(actual);
+  EXPECT_EQ(expected.str(), actual.str());
+}
+
+TEST(XmlPullParser, malformed) {
+  std::istringstream in("<a><b></a>");
+  common::XmlPullParser parser(in);
+  EXPECT_THROW(
+      while (parser.next() != Event::END_DOCUMENT) {},
+      common::NotXmlException);
+}
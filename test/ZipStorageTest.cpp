@@ -1,7 +1,11 @@
 #include <access/Path.h>
+#include <access/StorageUtil.h>
 #include <access/ZipStorage.h>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <iterator>
 #include <string>
+#include <vector>
 
 using namespace odr::access;
 
@@ -82,4 +86,111 @@ TEST(ZipWriter, create_order) {
   }
 }
 
+TEST(ZipReader, fingerprint) {
+  const auto create = [](const std::string &file, const std::string &content) {
+    ZipWriter writer(file);
+    const auto sink = writer.write("content.txt");
+    sink->write(content.data(), content.size());
+  };
+
+  create("fingerprint_a.zip", "first");
+  create("fingerprint_b.zip", "first");
+  create("fingerprint_c.zip", "other");
+
+  const std::string a = ZipReader("fingerprint_a.zip").fingerprint();
+  EXPECT_EQ(32, a.size());
+  EXPECT_EQ(a, ZipReader("fingerprint_b.zip").fingerprint());
+  EXPECT_NE(a, ZipReader("fingerprint_c.zip").fingerprint());
+}
+
+namespace {
+std::string checkpointsContent() {
+  std::string result;
+  for (int i = 0; result.size() < 300000; ++i) {
+    result += "<row r=\"" + std::to_string(i * 7919 % 100003) + "\"/>";
+  }
+  return result;
+}
+
+void checkpoints(const ZipReader &reader, const std::string &content) {
+  ZipReader::Checkpoints checkpoints(16 * 1024);
+  {
+    const auto in = reader.read("content.xml", checkpoints);
+    EXPECT_EQ(content, std::string(std::istreambuf_iterator<char>(*in), {}));
+  }
+  EXPECT_LT(10, checkpoints.size());
+
+  const std::vector<std::uint64_t> offsets{0, 12345, 100000, 299999};
+  for (auto &&offset : offsets) {
+    const auto in = reader.read("content.xml", checkpoints, offset);
+    EXPECT_EQ(content.substr(offset),
+              std::string(std::istreambuf_iterator<char>(*in), {}));
+  }
+
+  checkpoints.retain(offsets);
+  EXPECT_GE(offsets.size(), checkpoints.size());
+  const auto in = reader.read("content.xml", checkpoints, 100000);
+  EXPECT_EQ(content.substr(100000),
+            std::string(std::istreambuf_iterator<char>(*in), {}));
+}
+} // namespace
+
+TEST(ZipReader, checkpoints) {
+  const std::string content = checkpointsContent();
+  {
+    ZipWriter writer("checkpoints.zip");
+    const auto sink = writer.write("content.xml");
+    sink->write(content.data(), content.size());
+  }
+
+  checkpoints(ZipReader("checkpoints.zip"), content);
+}
+
+TEST(ZipReader, checkpointsStored) {
+  const std::string content = checkpointsContent();
+  {
+    ZipWriter writer("checkpoints_stored.zip");
+    const auto sink = writer.write("content.xml", 0);
+    sink->write(content.data(), content.size());
+  }
+
+  checkpoints(ZipReader("checkpoints_stored.zip"), content);
+}
+
+TEST(ZipReader, checkpointsInMemory) {
+  // like a decrypted package
+  const std::string content = checkpointsContent();
+  for (int compression : {0, 6}) {
+    {
+      ZipWriter writer("checkpoints_memory.zip");
+      const auto sink = writer.write("content.xml", compression);
+      sink->write(content.data(), content.size());
+    }
+    std::ifstream file("checkpoints_memory.zip", std::ios::binary);
+    const std::string zip(std::istreambuf_iterator<char>(file), {});
+
+    checkpoints(ZipReader(zip, false), content);
+  }
+}
+
+TEST(StorageUtil, peek) {
+  std::string content;
+  while (content.size() < 100000) {
+    content += "<c r=\"A" + std::to_string(content.size()) + "\"/>";
+  }
+  {
+    ZipWriter writer("peek.zip");
+    const auto sink = writer.write("content.xml");
+    sink->write(content.data(), content.size());
+  }
+
+  const ZipReader reader("peek.zip");
+  EXPECT_EQ(content.substr(0, 1000),
+            StorageUtil::peek(reader, "content.xml", 1000));
+  EXPECT_EQ(content, StorageUtil::peek(reader, "content.xml", 1000000));
+  EXPECT_EQ("", StorageUtil::peek(reader, "content.xml", 0));
+  EXPECT_THROW(StorageUtil::peek(reader, "missing.xml", 1000),
+               FileNotFoundException);
+}
+
 // TODO copy test